@@ -24,14 +24,61 @@ extern "C" {
   #define DELAY(x)  for(uint32_t i = 0; i < (x * 10000U); i++) { __asm("nop"); }
 #endif
 
+static constexpr uint8_t ADC_TEMPERATURE_CHANNEL = 26; /**< ADC0 channel of the internal temperature sensor. */
+static constexpr uint8_t ADC_MAX_SCAN_CHANNELS   = 4;  /**< Channels a continuous scan may cycle through. */
+
+/**
+ * @brief Hardware averaging depth of ADC0 (results per reported value).
+ */
+enum class AdcAveraging : uint8_t
+{
+    NONE       = 0,
+    SAMPLES_4  = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(0),
+    SAMPLES_8  = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(1),
+    SAMPLES_16 = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(2),
+    SAMPLES_32 = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(3)
+};
+
 /**
  * @brief Initializes the ADC peripheral.
  * @return 0 if successful, otherwise non-zero if calibration failed.
  */
 uint8_t ADC_Init();
 
+/**
+ * @brief Starts continuous conversions that cycle through a list of channels.
+ *
+ * ADC0 runs in continuous-conversion mode with its conversion-complete interrupt enabled.
+ * ADC0_IRQHandler stores each averaged result as the latest value of its channel and, for
+ * more than one channel, retargets the converter to the next one, so the CPU never waits
+ * for a conversion. Calling it again replaces the running scan.
+ *
+ * @param channels Channels to convert, in order (copied).
+ * @param count Number of channels, 1 to ADC_MAX_SCAN_CHANNELS.
+ * @param averaging Hardware averaging depth applied to every channel.
+ * @return False if count is out of range (a running scan is then left unchanged).
+ */
+bool ADC_StartScan(const uint8_t* channels, uint8_t count, AdcAveraging averaging);
+
+/**
+ * @brief Stops the continuous scan; the last stored values are dropped.
+ */
+void ADC_StopScan();
+
+/**
+ * @brief Returns the latest scanned result of a channel without starting a conversion.
+ * @param channel Channel number.
+ * @param value Output conversion result.
+ * @return False if the channel is not being scanned or has no result yet.
+ */
+bool ADC_LatestValue(uint8_t channel, uint16_t& value);
+
 /**
  * @brief Reads the specified ADC channel.
+ *
+ * Returns the latest scanned value at once if the channel is part of the running scan.
+ * Otherwise the scan is paused for one blocking conversion and resumed afterwards.
+ *
  * @param channel Channel number to read.
  * @return The ADC conversion result (12-bit or 16-bit, depending on configuration).
  */
@@ -39,9 +86,14 @@ uint16_t ADC_ReadChannel(uint8_t channel);
 
 /**
  * @brief Reads and calculates the internal temperature from ADC data.
- * @return Temperature in degrees Celsius.
+ *
+ * Integer-only: the sensor's linear transfer function is folded into a Q12 slope and offset
+ * at compile time, so a reading costs one multiply, one add and one shift (no soft-float).
+ * While ADC_TEMPERATURE_CHANNEL is part of the continuous scan, the latest value is used.
+ *
+ * @return Temperature in hundredths of a degree Celsius.
  */
-float readTemperature();
+int16_t readTemperature();
 
 /**
  * @brief Initializes the GPIO pins for the on-board RGB LED.
@@ -59,20 +111,79 @@ void setLedColor(bool r, bool g, bool b);
 /**
  * @namespace I2C
  * @brief Contains I2C-related methods for communication with external peripherals.
+ *
+ * Transfers are interrupt-driven: submit() queues a register transfer and returns at once,
+ * I2C0_IRQHandler advances it byte by byte and sets its status when the STOP is issued.
+ * A transfer that makes no bus progress for TIMEOUT_MS is aborted from the SysTick
+ * interrupt, so SysTick_Init() must have been called before waiting on a transfer.
+ * writeReg(), readReg() and readRegBlock() are blocking wrappers around submit() and wait().
  */
 namespace I2C
 {
+    static constexpr uint8_t OK                = 0;    /**< Transfer completed and acknowledged. */
+    static constexpr uint8_t ERROR_NACK        = 1;    /**< The device did not acknowledge its address or a byte. */
+    static constexpr uint8_t ERROR_TIMEOUT     = 2;    /**< No bus progress within TIMEOUT_MS. */
+    static constexpr uint8_t ERROR_ARBITRATION = 3;    /**< Arbitration lost or the bus was not released. */
+    static constexpr uint8_t ERROR_QUEUE_FULL  = 4;    /**< submit() found no free queue slot. */
+    static constexpr uint8_t PENDING           = 0xFF; /**< Queued or in progress. */
+
+    static constexpr uint8_t QUEUE_SIZE  = 8;  /**< Transfers that may be queued at once, a power of two. */
+    static constexpr uint32_t TIMEOUT_MS = 3;  /**< Longest silence between two bus events (a byte takes ~0.1 ms). */
+
+    /**
+     * @struct Transfer
+     * @brief One register write or register read, owned by the caller until its status leaves PENDING.
+     */
+    struct Transfer
+    {
+        uint8_t address;                        /**< 7-bit I2C device address. */
+        uint8_t reg;                            /**< First register address on the device. */
+        uint8_t* data;                          /**< Bytes to write, or destination of the bytes read. */
+        uint8_t size;                           /**< Number of data bytes (at least 1 for a read). */
+        bool read;                              /**< True for a register read (repeated START), false for a write. */
+        void (*onComplete)(Transfer&) = nullptr;/**< Optional callback, runs in interrupt context on completion. */
+        volatile uint8_t status = OK;           /**< PENDING while queued, then OK or an ERROR_* code. */
+    };
+
     /**
-     * @brief Initializes the I2C0 peripheral for standard mode (~100kHz).
+     * @brief Initializes the I2C0 peripheral for standard mode (~100kHz) and enables its interrupt.
      */
     void init();
 
+    /**
+     * @brief Queues a transfer and starts it if the bus is idle. Never waits.
+     * @param transfer Transfer to run; must stay valid until its status leaves PENDING.
+     * @return False if the queue is full (the status is then ERROR_QUEUE_FULL).
+     */
+    bool submit(Transfer& transfer);
+
+    /**
+     * @brief Returns true once the transfer has completed or failed.
+     * @param transfer Previously submitted transfer.
+     * @return False while the transfer is queued or in progress.
+     */
+    inline bool isComplete(const Transfer& transfer) { return transfer.status != PENDING; }
+
+    /**
+     * @brief Waits until the transfer has completed or failed (must not be called with interrupts masked).
+     * @param transfer Previously submitted transfer.
+     * @return OK or an ERROR_* code.
+     */
+    uint8_t wait(const Transfer& transfer);
+
+    /**
+     * @brief Returns a short description of a status code for text responses.
+     * @param status OK, PENDING or an ERROR_* code.
+     * @return Null-terminated description.
+     */
+    const char* statusText(uint8_t status);
+
     /**
      * @brief Writes data to a specific register of an I2C device.
      * @param address 7-bit I2C device address.
      * @param reg Register address on the I2C device.
      * @param data Byte to write to the register.
-     * @return 0 if successful, non-zero otherwise.
+     * @return OK if successful, otherwise an ERROR_* code.
      */
     uint8_t writeReg(uint8_t address, uint8_t reg, uint8_t data);
 
@@ -81,7 +192,7 @@ namespace I2C
      * @param address 7-bit I2C device address.
      * @param reg Register address on the I2C device.
      * @param data Pointer to a variable where the read byte will be stored.
-     * @return 0 if successful, non-zero otherwise.
+     * @return OK if successful, otherwise an ERROR_* code.
      */
     uint8_t readReg(uint8_t address, uint8_t reg, uint8_t* data);
 
@@ -91,7 +202,7 @@ namespace I2C
      * @param reg Starting register address on the I2C device.
      * @param size Number of bytes to read.
      * @param data Pointer to a buffer where the read bytes will be stored.
-     * @return 0 if successful, non-zero otherwise.
+     * @return OK if successful, otherwise an ERROR_* code.
      */
     uint8_t readRegBlock(uint8_t address, uint8_t reg, uint8_t size, uint8_t* data);
 }
@@ -112,4 +223,15 @@ uint8_t TSI_ReadSlider();
  */
 void self_calibration();
 
+/**
+ * @brief Starts SysTick as a 1 ms time base for millis().
+ */
+void SysTick_Init();
+
+/**
+ * @brief Returns the time since SysTick_Init() was called.
+ * @return Elapsed milliseconds (wraps after about 49 days).
+ */
+uint32_t millis();
+
 #endif // BOARD_SUPPORT_HPP
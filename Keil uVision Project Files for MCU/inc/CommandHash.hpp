@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file CommandHash.hpp
+ * @brief Compile-time perfect hashing of the text command table.
+ *
+ * The seed of a small multiplicative hash is searched at compile time until every command
+ * word lands in its own slot, so a lookup costs one hash over the received word, one table
+ * read and a single confirming string compare, independent of the number of commands.
+ */
+
+#ifndef COMMAND_HASH_HPP
+#define COMMAND_HASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mb {
+
+/**
+ * @namespace CommandHash
+ * @brief constexpr helpers that build and query a collision-free command slot table.
+ */
+namespace CommandHash
+{
+    static constexpr uint32_t MAX_SEED = 4096; /**< Seeds tried before giving up (build() then returns an invalid table). */
+
+    /**
+     * @brief Returns the length of the command word (up to the first ' ' or the end of the string).
+     * @param text Command string.
+     * @return Number of characters in the first word.
+     */
+    constexpr size_t wordLength(const char* text)
+    {
+        size_t length = 0;
+        while (text[length] != '\0' && text[length] != ' ')
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    /**
+     * @brief FNV-1a style hash with a variable starting value.
+     * @param text Characters to hash.
+     * @param length Number of characters.
+     * @param seed Starting value selected by build().
+     * @return Hash value.
+     */
+    constexpr uint32_t hash(const char* text, size_t length, uint32_t seed)
+    {
+        uint32_t value = 2166136261u ^ seed;
+        for (size_t i = 0; i < length; ++i)
+        {
+            value = (value ^ static_cast<uint8_t>(text[i])) * 16777619u;
+        }
+        return value ^ (value >> 15); // Fold the well-mixed high bits into the slot index
+    }
+
+    /**
+     * @struct Table
+     * @brief Seed and slot map produced by build().
+     * @tparam Slots Number of slots, a power of two.
+     */
+    template <size_t Slots>
+    struct Table
+    {
+        static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+        uint32_t seed = 0;       /**< Seed for which every command has its own slot. */
+        bool valid = false;      /**< False if no collision-free seed was found. */
+        uint8_t slots[Slots] {}; /**< Index of the command in a slot plus one, 0 for an empty slot. */
+
+        /**
+         * @brief Returns the command index stored for a word.
+         * @param text Word to look up (need not be null-terminated after the word).
+         * @param length Length of the word.
+         * @return Index into the command table plus one, or 0 if the slot is empty. The caller
+         *         must confirm the match with one string compare.
+         */
+        constexpr uint8_t find(const char* text, size_t length) const
+        {
+            return slots[hash(text, length, seed) & (Slots - 1)];
+        }
+    };
+
+    /**
+     * @brief Searches for a seed that maps every command name to a distinct slot.
+     * @tparam Slots Number of slots, a power of two larger than the number of commands.
+     * @tparam Entry Table entry type with a const char* member called name.
+     * @tparam N Number of commands.
+     * @param entries Command table.
+     * @return Collision-free table, or one with valid == false (checked by a static_assert at the call site).
+     */
+    template <size_t Slots, typename Entry, size_t N>
+    constexpr Table<Slots> build(const Entry (&entries)[N])
+    {
+        static_assert(N < Slots && N < 255, "Command table does not fit the slot table");
+
+        for (uint32_t seed = 0; seed < MAX_SEED; ++seed)
+        {
+            Table<Slots> table {};
+            table.seed = seed;
+            table.valid = true;
+
+            for (size_t i = 0; i < N && table.valid; ++i)
+            {
+                const size_t slot = hash(entries[i].name, wordLength(entries[i].name), seed) & (Slots - 1);
+                if (table.slots[slot] != 0)
+                {
+                    table.valid = false; // Collision (or a duplicate name): try the next seed
+                }
+                table.slots[slot] = static_cast<uint8_t>(i + 1);
+            }
+
+            if (table.valid)
+            {
+                return table;
+            }
+        }
+        return Table<Slots> {};
+    }
+} // End of namespace CommandHash
+
+} // End of namespace mb
+
+#endif // COMMAND_HASH_HPP
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file MMA8451.hpp
+ * @brief Driver for the on-board MMA8451Q accelerometer on the I2C0 bus.
+ */
+
+#ifndef MMA8451_HPP
+#define MMA8451_HPP
+
+#include <cstdint>
+
+#include "BasicAccelerometer.hpp"
+#include "BoardSupport.hpp"
+
+extern "C" void PORTA_IRQHandler(void);
+
+namespace mb {
+
+/**
+ * @class MMA8451
+ * @brief Configures the MMA8451Q once and captures its samples from the INT1 interrupt.
+ *
+ * The configuration registers are cached, so the sensor is only written to in init(),
+ * configure(), startCapture() and stopCapture(), which put it into standby, apply the
+ * cached settings and activate it again. A capture that stalled, e.g. because the sensor
+ * was power cycled, is recovered by calling startCapture() again.
+ *
+ * While capturing, sampling is paced by the sensor's own output data rate, not by the
+ * host: INT1 (PTA10) raises PORTA_IRQHandler, which queues an asynchronous I2C read, and
+ * the completion callback stores the samples with their millis() timestamp in a RAM ring.
+ * Up to 200 Hz every sample raises a data-ready interrupt; at 400 and 800 Hz the hardware
+ * FIFO collects FIFO_WATERMARK samples per interrupt, which are then read in one burst.
+ * The main loop only reads from the ring (popSample()) or the newest sample (latestSample()).
+ */
+class MMA8451
+{
+public:
+    static constexpr uint8_t I2C_ADDRESS = 0x1D; /**< 7-bit address on the FRDM-KL05Z (SA0 pulled high). */
+
+    /**
+     * @brief Full-scale range (XYZ_DATA_CFG FS bits).
+     */
+    enum class Range : uint8_t
+    {
+        G2 = 0x00,  /**< +-2 g, 4096 counts per g (14-bit). */
+        G4 = 0x01,  /**< +-4 g, 2048 counts per g. */
+        G8 = 0x02   /**< +-8 g, 1024 counts per g. */
+    };
+
+    /**
+     * @brief Output data rate (CTRL_REG1 DR bits).
+     */
+    enum class DataRate : uint8_t
+    {
+        HZ_800 = 0,
+        HZ_400 = 1,
+        HZ_200 = 2,
+        HZ_100 = 3,
+        HZ_50 = 4,
+        HZ_12_5 = 5,
+        HZ_6_25 = 6,
+        HZ_1_56 = 7
+    };
+
+    /**
+     * @brief Oversampling mode in the active state (CTRL_REG2 MODS bits).
+     */
+    enum class Oversampling : uint8_t
+    {
+        NORMAL = 0,              /**< Default trade-off. */
+        LOW_NOISE_LOW_POWER = 1, /**< Fewer samples per output, reduced noise. */
+        HIGH_RESOLUTION = 2,     /**< Most oversampling, lowest noise. */
+        LOW_POWER = 3            /**< Least oversampling, lowest current. */
+    };
+
+    static constexpr uint8_t SAMPLE_SIZE = 6;      /**< Bytes per 14-bit XYZ sample (X/Y/Z, MSB first). */
+    static constexpr uint8_t FAST_SAMPLE_SIZE = 3; /**< Bytes per 8-bit XYZ sample in fast-read mode (MSBs only). */
+    static constexpr uint8_t FIFO_SIZE = 32;       /**< Samples held by the hardware FIFO. */
+    static constexpr uint8_t FIFO_WATERMARK = 16;  /**< FIFO samples per interrupt at 400 and 800 Hz. */
+    static constexpr uint8_t RING_SIZE = 32;       /**< Captured samples buffered for the main loop, a power of two. */
+
+    /**
+     * @struct Sample
+     * @brief One captured XYZ sample.
+     */
+    struct Sample
+    {
+        uint32_t timestampMs;       /**< millis() at which the sensor produced the sample. */
+        RawAccelerometer counts;    /**< X/Y/Z counts, left-justified in 16 bits as the sensor reports them. */
+        uint8_t length;             /**< Bytes the sample was read as: SAMPLE_SIZE, or FAST_SAMPLE_SIZE in fast-read mode. */
+    };
+
+private:
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+    static constexpr uint8_t REG_STATUS       = 0x00; /**< F_STATUS while the FIFO is enabled. */
+    static constexpr uint8_t REG_OUT_X_MSB    = 0x01;
+    static constexpr uint8_t REG_F_SETUP      = 0x09;
+    static constexpr uint8_t REG_XYZ_DATA_CFG = 0x0E;
+    static constexpr uint8_t REG_CTRL_REG1    = 0x2A;
+    static constexpr uint8_t REG_CTRL_REG2    = 0x2B;
+    static constexpr uint8_t REG_CTRL_REG4    = 0x2D; /**< Interrupt enables. */
+    static constexpr uint8_t REG_CTRL_REG5    = 0x2E; /**< Interrupt routing, 1 = INT1. */
+
+    static constexpr uint8_t CTRL_REG1_ACTIVE = 0x01; /**< Active (sampling) instead of standby. */
+    static constexpr uint8_t CTRL_REG1_F_READ = 0x02; /**< Fast read: auto-increment skips the LSB registers. */
+    static constexpr uint8_t CTRL_REG1_DR_SHIFT = 3;  /**< Position of the data rate field. */
+    static constexpr uint8_t F_SETUP_CIRCULAR = 0x40; /**< F_MODE: keep the newest samples, drop the oldest. */
+    static constexpr uint8_t F_STATUS_COUNT = 0x3F;   /**< F_CNT: number of samples in the FIFO. */
+    static constexpr uint8_t INT_DRDY = 0x01;         /**< Data-ready bit in CTRL_REG4/CTRL_REG5. */
+    static constexpr uint8_t INT_FIFO = 0x40;         /**< FIFO bit in CTRL_REG4/CTRL_REG5. */
+    static constexpr uint8_t INT1_PIN = 10;           /**< PTA10 is wired to the sensor's INT1 (active low). */
+
+    static MMA8451* g_captureObject; /**< Driver served by PORTA_IRQHandler. */
+
+    uint8_t ctrlReg1;          /**< Cached CTRL_REG1 value in the active state. */
+    uint8_t ctrlReg2;          /**< Cached CTRL_REG2 value. */
+    uint8_t xyzDataCfg;        /**< Cached XYZ_DATA_CFG value. */
+    uint8_t fSetup = 0;        /**< Cached F_SETUP value, 0 while the FIFO is disabled. */
+    uint8_t ctrlReg4 = 0;      /**< Cached CTRL_REG4 value (enabled interrupt). */
+    uint8_t ctrlReg5 = 0;      /**< Cached CTRL_REG5 value (interrupt routed to INT1). */
+    bool configured = false;   /**< True once the cached settings were written successfully. */
+
+    // Capture state: the ring is filled in interrupt context (I2C completion) and emptied
+    // by the main loop. Indices run freely and wrap.
+    Sample ring[RING_SIZE];                     /**< Captured samples, oldest at ringTail. */
+    volatile uint8_t ringHead = 0;              /**< Next slot to fill (written by the interrupt only). */
+    volatile uint8_t ringTail = 0;              /**< Oldest unread slot (written by the main loop only). */
+    Sample latest {};                           /**< Newest sample, kept even when the ring is full. */
+    volatile bool hasLatest = false;            /**< True once latest holds a sample. */
+    volatile uint32_t overruns = 0;             /**< Samples dropped because the ring was full. */
+    volatile bool capturing = false;            /**< True while INT1 triggers reads. */
+    volatile bool reading = false;              /**< True while an interrupt-driven read is in flight. */
+    uint32_t captureMs = 0;                     /**< millis() when the pending read was triggered. */
+    uint8_t fifoStatus = 0;                     /**< F_STATUS read by the pending FIFO drain. */
+    uint8_t staging[FIFO_SIZE * SAMPLE_SIZE];   /**< Destination of the pending burst read. */
+    I2C::Transfer statusTransfer {};            /**< F_STATUS read of a FIFO drain. */
+    I2C::Transfer dataTransfer {};              /**< Output register read (one sample or a FIFO burst). */
+
+public:
+    /**
+     * @brief Stores the settings; the sensor is not accessed until init().
+     * @param range Full-scale range.
+     * @param rate Output data rate.
+     * @param mode Oversampling mode.
+     */
+    explicit MMA8451(Range range = Range::G2, DataRate rate = DataRate::HZ_800,
+                     Oversampling mode = Oversampling::NORMAL);
+
+    /**
+     * @brief Writes the cached settings to the sensor and activates it (I2C must be initialized).
+     * @return I2C::OK, or the I2C error code of the first failed transfer.
+     */
+    uint8_t init();
+
+    /**
+     * @brief Changes the settings and writes them to the sensor (a running capture continues,
+     *        samples captured with a different range are discarded).
+     * @param range Full-scale range.
+     * @param rate Output data rate.
+     * @param mode Oversampling mode.
+     * @return I2C::OK, or the I2C error code of the first failed transfer.
+     */
+    uint8_t configure(Range range, DataRate rate, Oversampling mode);
+
+    /**
+     * @brief Switches between 14-bit samples and 8-bit fast-read samples (a running capture continues,
+     *        samples captured in the other layout are discarded).
+     *
+     * In fast-read mode each read and each FIFO entry carries only the three MSB registers,
+     * which halves the I2C and UART bytes per sample at 1/64 g resolution in the +-2 g range.
+     *
+     * @param enabled True for 8-bit samples.
+     * @return I2C::OK, or the I2C error code of the first failed transfer.
+     */
+    uint8_t setFastRead(bool enabled);
+
+    /**
+     * @brief Returns the number of bytes per sample in the current mode.
+     * @return SAMPLE_SIZE, or FAST_SAMPLE_SIZE in fast-read mode.
+     */
+    uint8_t sampleSize() const { return (ctrlReg1 & CTRL_REG1_F_READ) ? FAST_SAMPLE_SIZE : SAMPLE_SIZE; }
+
+    /**
+     * @brief Routes the data-ready (or FIFO watermark) interrupt to PTA10 and starts capturing.
+     * @return I2C::OK, or the I2C error code of the first failed transfer (capture is then off).
+     */
+    uint8_t startCapture();
+
+    /**
+     * @brief Stops capturing and disables the sensor interrupts.
+     * @return I2C::OK, or the I2C error code of the first failed transfer.
+     */
+    uint8_t stopCapture();
+
+    /**
+     * @brief Returns true while samples are being captured (false after a failed interrupt-driven read).
+     * @return Capture state.
+     */
+    bool isCapturing() const { return capturing; }
+
+    /**
+     * @brief Takes the oldest captured sample out of the ring.
+     * @param sample Output sample.
+     * @return False if the ring is empty.
+     */
+    bool popSample(Sample& sample);
+
+    /**
+     * @brief Copies the newest captured sample, without removing anything from the ring.
+     * @param sample Output sample.
+     * @return False if nothing was captured yet.
+     */
+    bool latestSample(Sample& sample) const;
+
+    /**
+     * @brief Returns and resets the number of samples dropped because the ring was full.
+     * @return Dropped samples since the previous call.
+     */
+    uint32_t takeOverruns();
+
+    /**
+     * @brief Returns the configured full-scale range.
+     * @return Range.
+     */
+    Range getRange() const { return static_cast<Range>(xyzDataCfg & 0x03); }
+
+    /**
+     * @brief Returns the configured output data rate.
+     * @return Data rate.
+     */
+    DataRate getDataRate() const { return static_cast<DataRate>((ctrlReg1 >> CTRL_REG1_DR_SHIFT) & 0x07); }
+
+    /**
+     * @brief Returns the configured oversampling mode.
+     * @return Oversampling mode.
+     */
+    Oversampling getOversampling() const { return static_cast<Oversampling>(ctrlReg2 & 0x03); }
+
+private:
+    /**
+     * @brief Puts the sensor into standby, writes the cached registers and activates it.
+     *        A running capture is paused meanwhile, so its reads do not interleave with the writes.
+     * @return I2C::OK, or the I2C error code of the first failed transfer.
+     */
+    uint8_t writeConfiguration();
+
+    /**
+     * @brief Drops the captured samples, e.g. because they were taken with another range or layout.
+     */
+    void discardSamples();
+
+    /**
+     * @brief Selects the interrupt source for the configured data rate (FIFO watermark at 400 Hz and above).
+     * @param enabled False to disable the sensor interrupts.
+     */
+    void selectInterrupt(bool enabled);
+
+    /**
+     * @brief Enables or masks the PTA10 interrupt (interrupt while the pin is low).
+     * @param enabled True to enable.
+     */
+    static void setPinInterrupt(bool enabled);
+
+    /**
+     * @brief Queues the reads for one interrupt (interrupt context).
+     */
+    void startRead();
+
+    /**
+     * @brief Ends the interrupt-driven read and unmasks INT1 again (interrupt context).
+     * @param succeeded False after a failed transfer: the capture is then stopped.
+     */
+    void finishRead(bool succeeded);
+
+    /**
+     * @brief Stores count samples of sampleSize() bytes from staging in the ring, timestamped back from captureMs.
+     * @param count Number of samples in staging.
+     */
+    void storeSamples(uint8_t count);
+
+    /**
+     * @brief I2C completion callback of the F_STATUS read: queues the FIFO burst.
+     * @param transfer Completed transfer.
+     */
+    static void onStatusRead(I2C::Transfer& transfer);
+
+    /**
+     * @brief I2C completion callback of the output register read: stores the samples.
+     * @param transfer Completed transfer.
+     */
+    static void onDataRead(I2C::Transfer& transfer);
+
+    /**
+     * @brief Handles the PORTA interrupt raised by INT1.
+     */
+    static void handleIRQ();
+
+    friend void ::PORTA_IRQHandler(); // Allows the global IRQ handler to invoke private handleIRQ().
+};
+
+} // End of namespace mb
+
+#endif // MMA8451_HPP
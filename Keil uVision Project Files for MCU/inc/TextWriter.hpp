@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file TextWriter.hpp
+ * @brief Minimal integer, hex and fixed-point text formatting for replies, without printf.
+ */
+
+#ifndef TEXT_WRITER_HPP
+#define TEXT_WRITER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mb {
+
+/**
+ * @class BufferSink
+ * @brief TextWriter output into a caller-provided buffer, always kept null-terminated.
+ *
+ * Output that does not fit is truncated.
+ */
+class BufferSink
+{
+private:
+    char* begin; /**< Start of the buffer. */
+    char* pos;   /**< Position of the terminating '\0'. */
+    char* last;  /**< Last byte of the buffer, reserved for the '\0'. */
+
+public:
+    /**
+     * @brief Starts writing at the beginning of a buffer and terminates it.
+     * @param buffer Destination buffer.
+     * @param size Size of the buffer in bytes, at least 1.
+     */
+    constexpr BufferSink(char* buffer, size_t size)
+        : begin(buffer), pos(buffer), last(buffer + size - 1)
+    {
+        *pos = '\0';
+    }
+
+    /**
+     * @brief Appends a single character if there is room for it.
+     * @param c Character to append.
+     */
+    constexpr void put(char c)
+    {
+        if (pos < last)
+        {
+            *pos++ = c;
+            *pos = '\0';
+        }
+    }
+
+    /**
+     * @brief Returns the text written so far.
+     * @return Null-terminated buffer contents.
+     */
+    constexpr const char* c_str() const { return begin; }
+
+    /**
+     * @brief Returns the number of characters written so far.
+     * @return Length without the terminating '\0'.
+     */
+    constexpr size_t length() const { return static_cast<size_t>(pos - begin); }
+};
+
+/**
+ * @class BasicTextWriter
+ * @brief Appends text and numbers to a sink that takes one character at a time.
+ *
+ * Replaces snprintf for the handful of formats the firmware needs, so the C library's printf
+ * (several KB of flash and a large stack frame) is not linked. Numbers are converted with one
+ * division by ten per digit and no varargs. The sink decides where the characters go: a
+ * buffer (TextWriter) or the UART transmit ring (Uart::TxSink). Every member is constexpr, so
+ * replies can also be assembled at compile time.
+ *
+ * @tparam Sink Type with put(char); its constructor arguments are those of the writer.
+ */
+template <typename Sink>
+class BasicTextWriter
+{
+private:
+    Sink out; /**< Destination of the characters. */
+
+public:
+    /**
+     * @brief Constructs the sink from the given arguments.
+     * @param args Arguments of the Sink constructor.
+     */
+    template <typename... Args>
+    constexpr explicit BasicTextWriter(Args... args)
+        : out(args...)
+    {
+    }
+
+    /**
+     * @brief Appends a single character.
+     * @param c Character to append.
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& character(char c)
+    {
+        out.put(c);
+        return *this;
+    }
+
+    /**
+     * @brief Appends a null-terminated string.
+     * @param string String to append.
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& text(const char* string)
+    {
+        while (*string != '\0')
+        {
+            out.put(*string++);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Appends an unsigned number in decimal, like "%u".
+     * @param value Number to append.
+     * @param minDigits Pad with leading zeros to at least this many digits (at most 10).
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& decimal(uint32_t value, uint8_t minDigits = 1)
+    {
+        char digits[10] {};
+        uint8_t count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+
+        while (count < minDigits && count < sizeof(digits))
+        {
+            digits[count++] = '0';
+        }
+        while (count > 0)
+        {
+            character(digits[--count]);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Appends a signed number in decimal, like "%d".
+     * @param value Number to append.
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& signedDecimal(int32_t value)
+    {
+        if (value < 0)
+        {
+            character('-');
+        }
+        // Negate in unsigned arithmetic, so INT32_MIN does not overflow
+        return decimal((value < 0) ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value));
+    }
+
+    /**
+     * @brief Appends a number in upper-case hex with a fixed number of digits, like "%08X".
+     * @param value Number to append.
+     * @param digits Number of digits (1 to 8); higher digits of value are dropped.
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& hex(uint32_t value, uint8_t digits = 8)
+    {
+        for (int shift = 4 * (digits - 1); shift >= 0; shift -= 4)
+        {
+            character("0123456789ABCDEF"[(value >> shift) & 0xFu]);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Appends a fixed-point number, e.g. fixed(-325, 2) gives "-3.25".
+     *
+     * The sign is written separately from the integer part, so values between -1 and 0 keep it.
+     *
+     * @param scaled Value multiplied by 10^decimals.
+     * @param decimals Number of fractional digits (1 to 9).
+     * @return This writer, for chaining.
+     */
+    constexpr BasicTextWriter& fixed(int32_t scaled, uint8_t decimals)
+    {
+        uint32_t divisor = 1;
+        for (uint8_t i = 0; i < decimals; ++i)
+        {
+            divisor *= 10;
+        }
+
+        uint32_t magnitude = (scaled < 0) ? 0u - static_cast<uint32_t>(scaled) : static_cast<uint32_t>(scaled);
+        if (scaled < 0)
+        {
+            character('-');
+        }
+        return decimal(magnitude / divisor).character('.').decimal(magnitude % divisor, decimals);
+    }
+
+    /**
+     * @brief Returns the sink, e.g. to commit what was written.
+     * @return The sink.
+     */
+    constexpr Sink& sink() { return out; }
+
+    /**
+     * @brief Returns the text written so far (buffer sinks only).
+     * @return Null-terminated buffer contents.
+     */
+    constexpr const char* c_str() const { return out.c_str(); }
+
+    /**
+     * @brief Returns the number of characters written so far (buffer sinks only).
+     * @return Length without the terminating '\0'.
+     */
+    constexpr size_t length() const { return out.length(); }
+};
+
+/**
+ * @brief Writer into a caller-provided buffer: TextWriter(buffer, sizeof(buffer)).
+ */
+using TextWriter = BasicTextWriter<BufferSink>;
+
+} // End of namespace mb
+
+#endif // TEXT_WRITER_HPP
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file MMA8451.cpp
+ * @brief Implementation of the MMA8451Q accelerometer driver.
+ */
+
+#include "../inc/MMA8451.hpp"
+#include "../inc/BoardSupport.hpp"
+
+mb::MMA8451* mb::MMA8451::g_captureObject = nullptr;
+
+extern "C" void PORTA_IRQHandler(void)
+{
+    mb::MMA8451::handleIRQ();
+}
+
+namespace mb {
+
+MMA8451::MMA8451(Range range, DataRate rate, Oversampling mode)
+    : ctrlReg1(static_cast<uint8_t>((static_cast<uint8_t>(rate) << CTRL_REG1_DR_SHIFT) | CTRL_REG1_ACTIVE)),
+      ctrlReg2(static_cast<uint8_t>(mode)),
+      xyzDataCfg(static_cast<uint8_t>(range))
+{
+}
+
+uint8_t MMA8451::init()
+{
+    return writeConfiguration();
+}
+
+uint8_t MMA8451::configure(Range range, DataRate rate, Oversampling mode)
+{
+    bool rescaled = (static_cast<uint8_t>(range) != xyzDataCfg);
+    ctrlReg1 = static_cast<uint8_t>((static_cast<uint8_t>(rate) << CTRL_REG1_DR_SHIFT)
+                                    | (ctrlReg1 & CTRL_REG1_F_READ) | CTRL_REG1_ACTIVE);
+    ctrlReg2 = static_cast<uint8_t>(mode);
+    xyzDataCfg = static_cast<uint8_t>(range);
+    if (capturing)
+    {
+        selectInterrupt(true); // The data rate decides between data-ready and FIFO interrupts
+    }
+
+    uint8_t status = writeConfiguration();
+    if (rescaled)
+    {
+        discardSamples(); // Counts of the old range would be scaled with the new one
+    }
+    return status;
+}
+
+uint8_t MMA8451::setFastRead(bool enabled)
+{
+    bool relaid = (enabled != ((ctrlReg1 & CTRL_REG1_F_READ) != 0));
+    ctrlReg1 = static_cast<uint8_t>(enabled ? (ctrlReg1 | CTRL_REG1_F_READ) : (ctrlReg1 & ~CTRL_REG1_F_READ));
+
+    uint8_t status = writeConfiguration();
+    if (relaid)
+    {
+        discardSamples(); // Keep every captured sample in the current layout
+    }
+    return status;
+}
+
+uint8_t MMA8451::startCapture()
+{
+    g_captureObject = this;
+
+    SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
+    setPinInterrupt(false);
+    PTA->PDDR &= ~(1u << INT1_PIN); // Input, driven low by the sensor while an interrupt is pending
+
+    discardSamples(); // Drop samples of a previous capture
+    overruns = 0;
+
+    selectInterrupt(true);
+    capturing = true;
+    uint8_t status = writeConfiguration(); // Unmasks the pin interrupt on success
+    if (status != I2C::OK)
+    {
+        capturing = false;
+        return status;
+    }
+
+    NVIC_ClearPendingIRQ(PORTA_IRQn);
+    NVIC_EnableIRQ(PORTA_IRQn);
+    return status;
+}
+
+uint8_t MMA8451::stopCapture()
+{
+    capturing = false;
+    selectInterrupt(false);
+    return writeConfiguration();
+}
+
+void MMA8451::discardSamples()
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ringTail = ringHead;
+    hasLatest = false;
+    __set_PRIMASK(primask);
+}
+
+bool MMA8451::popSample(Sample& sample)
+{
+    uint8_t tail = ringTail;
+    if (tail == ringHead)
+    {
+        return false;
+    }
+
+    sample = ring[tail & (RING_SIZE - 1)];
+    ringTail = static_cast<uint8_t>(tail + 1); // Publish the free slot only after the copy
+    return true;
+}
+
+bool MMA8451::latestSample(Sample& sample) const
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq(); // The completion callback may overwrite latest halfway through the copy
+
+    bool available = hasLatest;
+    if (available)
+    {
+        sample = latest;
+    }
+
+    __set_PRIMASK(primask);
+    return available;
+}
+
+uint32_t MMA8451::takeOverruns()
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t count = overruns;
+    overruns = 0;
+    __set_PRIMASK(primask);
+    return count;
+}
+
+uint8_t MMA8451::writeConfiguration()
+{
+    // Pause the capture and let its read in flight finish, so its transfers stay out of the queue
+    bool resume = capturing;
+    capturing = false;
+    setPinInterrupt(false);
+    while (reading)
+    {
+    }
+
+    // Range and data rate can only be changed in standby, so leave it first and reactivate last
+    uint8_t standby = static_cast<uint8_t>(ctrlReg1 & ~CTRL_REG1_ACTIVE);
+    I2C::Transfer transfers[] = {
+        { I2C_ADDRESS, REG_CTRL_REG1, &standby, 1, false },
+        { I2C_ADDRESS, REG_XYZ_DATA_CFG, &xyzDataCfg, 1, false },
+        { I2C_ADDRESS, REG_CTRL_REG2, &ctrlReg2, 1, false },
+        { I2C_ADDRESS, REG_F_SETUP, &fSetup, 1, false },
+        { I2C_ADDRESS, REG_CTRL_REG4, &ctrlReg4, 1, false },
+        { I2C_ADDRESS, REG_CTRL_REG5, &ctrlReg5, 1, false },
+        { I2C_ADDRESS, REG_CTRL_REG1, &ctrlReg1, 1, false }
+    };
+
+    uint8_t status = I2C::OK;
+    for (I2C::Transfer& transfer : transfers)
+    {
+        I2C::submit(transfer);
+    }
+    for (const I2C::Transfer& transfer : transfers)
+    {
+        uint8_t result = I2C::wait(transfer);
+        if (status == I2C::OK)
+        {
+            status = result; // Report the first failure
+        }
+    }
+
+    configured = (status == I2C::OK);
+    capturing = resume;
+    if (capturing && configured)
+    {
+        setPinInterrupt(true); // INT1 may already be low: the interrupt then fires right away
+    }
+    return status;
+}
+
+void MMA8451::selectInterrupt(bool enabled)
+{
+    // Above 200 Hz an interrupt and a 6-byte read per sample would keep the 100 kHz bus
+    // almost permanently busy, so let the FIFO collect samples and drain it in bursts
+    bool useFifo = enabled && (getDataRate() <= DataRate::HZ_400);
+    fSetup = useFifo ? static_cast<uint8_t>(F_SETUP_CIRCULAR | FIFO_WATERMARK) : 0;
+    ctrlReg4 = !enabled ? 0 : (useFifo ? INT_FIFO : INT_DRDY);
+    ctrlReg5 = ctrlReg4; // Route the enabled source to INT1
+}
+
+void MMA8451::setPinInterrupt(bool enabled)
+{
+    // Writing ISF clears a flag left from before; the level interrupt re-raises it while INT1 is low
+    PORTA->PCR[INT1_PIN] = PORT_PCR_MUX(1) | PORT_PCR_ISF_MASK | (enabled ? PORT_PCR_IRQC(8) : 0);
+}
+
+void MMA8451::startRead()
+{
+    reading = true;
+    captureMs = millis();
+
+    if (fSetup != 0)
+    {
+        statusTransfer = { I2C_ADDRESS, REG_STATUS, &fifoStatus, 1, true, onStatusRead };
+        if (!I2C::submit(statusTransfer))
+        {
+            finishRead(false);
+        }
+    }
+    else
+    {
+        dataTransfer = { I2C_ADDRESS, REG_OUT_X_MSB, staging, sampleSize(), true, onDataRead };
+        if (!I2C::submit(dataTransfer))
+        {
+            finishRead(false);
+        }
+    }
+}
+
+void MMA8451::finishRead(bool succeeded)
+{
+    if (!succeeded)
+    {
+        // INT1 stays low after a failed read, so unmasking it would retrigger at once and
+        // keep retrying in interrupt context. Stop and leave the recovery to startCapture().
+        capturing = false;
+    }
+    reading = false;
+    if (capturing)
+    {
+        setPinInterrupt(true);
+    }
+}
+
+void MMA8451::storeSamples(uint8_t count)
+{
+    // The FIFO holds samples taken one period apart, the newest at about captureMs
+    static constexpr uint32_t PERIOD_US[] = { 1250, 2500, 5000, 10000, 20000, 80000, 160000, 640000 };
+    uint32_t periodUs = PERIOD_US[static_cast<uint8_t>(getDataRate())];
+    uint8_t size = sampleSize();
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        Sample sample {};
+        sample.timestampMs = captureMs - ((count - 1u - i) * periodUs) / 1000u;
+        sample.length = size;
+        sample.counts.parseRawData(staging + i * size, size);
+
+        uint8_t head = ringHead;
+        if (static_cast<uint8_t>(head - ringTail) < RING_SIZE)
+        {
+            ring[head & (RING_SIZE - 1)] = sample;
+            ringHead = static_cast<uint8_t>(head + 1);
+        }
+        else
+        {
+            ++overruns; // The main loop fell behind: keep the older samples, drop this one
+        }
+        latest = sample;
+    }
+    if (count > 0)
+    {
+        hasLatest = true;
+    }
+}
+
+void MMA8451::onStatusRead(I2C::Transfer& transfer)
+{
+    MMA8451* self = g_captureObject;
+    uint8_t count = self->fifoStatus & F_STATUS_COUNT;
+    if (transfer.status != I2C::OK || count == 0)
+    {
+        self->finishRead(transfer.status == I2C::OK);
+        return;
+    }
+
+    // In FIFO mode the register pointer wraps from the last output register back to OUT_X_MSB
+    // (OUT_Z_LSB, or OUT_Z_MSB in fast-read mode), so one burst pops count consecutive samples
+    self->dataTransfer = { I2C_ADDRESS, REG_OUT_X_MSB, self->staging,
+                           static_cast<uint8_t>(count * self->sampleSize()), true, onDataRead };
+    if (!I2C::submit(self->dataTransfer))
+    {
+        self->finishRead(false);
+    }
+}
+
+void MMA8451::onDataRead(I2C::Transfer& transfer)
+{
+    MMA8451* self = g_captureObject;
+    if (transfer.status == I2C::OK)
+    {
+        self->storeSamples(static_cast<uint8_t>(transfer.size / self->sampleSize()));
+    }
+    self->finishRead(transfer.status == I2C::OK);
+}
+
+void MMA8451::handleIRQ()
+{
+    MMA8451* self = g_captureObject;
+    setPinInterrupt(false); // Masked until the read completes, INT1 stays low until then
+    if (self != nullptr && self->capturing && !self->reading)
+    {
+        self->startRead();
+    }
+}
+
+} // End of namespace mb
@@ -12,6 +12,10 @@
 #include "../inc/CommunicationModuleMCU.hpp"
 
 mb::CommunicationModuleMCU* mb::Uart::g_commObject = nullptr;
+volatile uint8_t mb::Uart::txBuffer[mb::Uart::TX_BUFFER_SIZE];
+volatile size_t mb::Uart::txHead = 0;
+volatile size_t mb::Uart::txTail = 0;
+volatile bool mb::Uart::txIdle = true;
 
 extern "C" void UART0_IRQHandler(void)
 {
@@ -89,6 +93,56 @@ void Uart::print(const char* text)
     {
         sendChar(*text++);
     }
+    startTransmit();
+}
+
+void Uart::print(const char* text, size_t length)
+{
+    while (length--)
+    {
+        sendChar(*text++);
+    }
+    startTransmit();
+}
+
+bool Uart::tryPrint(const char* text, size_t length)
+{
+    if (txFree() < length)
+    {
+        return false;
+    }
+    print(text, length);
+    return true;
+}
+
+size_t Uart::txFree()
+{
+    // One slot stays empty so that a full ring can be told apart from an empty one
+    return TX_BUFFER_SIZE - 1 - ((txHead - txTail) & (TX_BUFFER_SIZE - 1));
+}
+
+void Uart::flush()
+{
+    startTransmit();
+    while (!txIdle)
+    {
+        // Wait until the transmit complete interrupt reports an empty shifter
+    }
+}
+
+Uart::TxSink::TxSink() : head(txHead), free(txFree()), overflow(false)
+{
+}
+
+bool Uart::TxSink::commit()
+{
+    if (overflow)
+    {
+        return false;
+    }
+    txHead = head; // Publish the whole line at once, after all of it is stored
+    startTransmit();
+    return true;
 }
 
 void Uart::println(const char* text)
@@ -99,11 +153,32 @@ void Uart::println(const char* text)
 
 void Uart::sendChar(char c)
 {
-    while (!(UART0->S1 & UART0_S1_TDRE_MASK))
+    if (txFree() == 0)
+    {
+        startTransmit(); // Backpressure: let the interrupt drain what is already queued
+        while (txFree() == 0)
+        {
+            // Wait until the transmit interrupt frees a slot
+        }
+    }
+
+    txBuffer[txHead] = static_cast<uint8_t>(c);
+    txHead = (txHead + 1) & (TX_BUFFER_SIZE - 1); // Publish the byte only after it is stored
+}
+
+void Uart::startTransmit()
+{
+    if (txHead == txTail)
     {
-        // Wait until the transmitter is ready
+        return;
     }
-    UART0->D = static_cast<uint8_t>(c);
+
+    // C2 is also changed by the interrupt, so update it with interrupts masked
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    txIdle = false;
+    UART0->C2 = static_cast<uint8_t>((UART0->C2 & ~UART0_C2_TCIE_MASK) | UART0_C2_TIE_MASK);
+    __set_PRIMASK(primask); // Callers that already masked interrupts keep them masked
 }
 
 void Uart::handleIRQ()
@@ -116,6 +191,25 @@ void Uart::handleIRQ()
             g_commObject->onCharReceived(c);
         }
     }
+
+    if ((UART0->C2 & UART0_C2_TIE_MASK) && (UART0->S1 & UART0_S1_TDRE_MASK))
+    {
+        if (txTail != txHead)
+        {
+            UART0->D = txBuffer[txTail];
+            txTail = (txTail + 1) & (TX_BUFFER_SIZE - 1);
+        }
+        else
+        {
+            // Ring drained: wait for the last byte to leave the shifter
+            UART0->C2 = static_cast<uint8_t>((UART0->C2 & ~UART0_C2_TIE_MASK) | UART0_C2_TCIE_MASK);
+        }
+    }
+    else if ((UART0->C2 & UART0_C2_TCIE_MASK) && (UART0->S1 & UART0_S1_TC_MASK))
+    {
+        UART0->C2 &= ~UART0_C2_TCIE_MASK;
+        txIdle = true;
+    }
 }
 
 } // End of namespace mb
\ No newline at end of file
@@ -8,7 +8,6 @@
  * @brief Main entry point of the FRDM-KL05Z application.
  */
 
-#include <cstdio>
 #include <cstdint>
 
 extern "C" {
@@ -34,15 +33,20 @@ extern "C" {
 
 int main()
 {
-
-
-		mb::CommunicationModuleMCU comm_obj;
-		mb::Uart start(9600, &comm_obj);
+    // Static, not on the stack: the module with its receive slots and sample ring is larger
+    // than the whole 1 KB stack (Stack_Size), see the static_assert in CommunicationModuleMCU.hpp
+    static mb::CommunicationModuleMCU comm_obj;
+    static mb::Uart start(9600, &comm_obj);
 
     I2C::init();
     LED_init();
     TSI_Init();
     ADC_Init();
+    SysTick_Init();
+
+    // Keep the temperature sensor converting in the background, so readtemp never waits on the ADC
+    static const uint8_t ADC_SCAN_CHANNELS[] = { ADC_TEMPERATURE_CHANNEL };
+    ADC_StartScan(ADC_SCAN_CHANNELS, sizeof(ADC_SCAN_CHANNELS), AdcAveraging::SAMPLES_32);
 
     comm_obj.init();
     setLedColor(true, false, false);
@@ -50,9 +54,16 @@ int main()
 
     while (true)
     {
-        // Wait for incoming data and handle the received command.
-        char* msg = comm_obj.receiveData();
-        comm_obj.handleCommand(msg);
+        // Handle a received command without blocking, so subscribed streams keep their cadence.
+        if (comm_obj.dataAvailable())
+        {
+            char* msg = comm_obj.receiveData();
+            comm_obj.handleCommand(msg);
+        }
+        comm_obj.serviceStreams();
+
+        // Sleep until the next interrupt; SysTick bounds the wake-up latency to 1 ms.
+        __WFI();
     }
 
     return 0;
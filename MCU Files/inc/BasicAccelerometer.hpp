@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file BasicAccelerometer.hpp
+ * @brief Accelerometer sample template over its scalar type: float g, raw counts, Q15 and Q31 fixed point.
+ *
+ * The header has no stream or container dependencies. The KL05Z firmware (no FPU) keeps its samples
+ * as RawAccelerometer; the PC build includes this file from MCU Files/inc and uses the float
+ * instantiation. The Keil project's copy must stay identical, which a host test checks.
+ * Host I/O (print(), operator<<) is in PC Files/inc/AccelerometerClass.hpp.
+ */
+
+#ifndef BASIC_ACCELEROMETER_HPP
+#define BASIC_ACCELEROMETER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace mb {
+
+    static constexpr unsigned int ACCEL_MAX_RANGE_G = 8; /**< Largest full-scale range; fixed-point values are fractions of it. */
+
+/**
+ * @struct Q15
+ * @brief Scalar tag for 16-bit fixed point: a Q15 fraction of +-ACCEL_MAX_RANGE_G, 1 LSB = 8 / 2^15 g (0.244 mg).
+ *
+ * The LSB equals that of a 14-bit sample at +-2 g, so every 14-bit or 8-bit sample at every
+ * range converts to Q15 exactly, independently of the range it was read at.
+ */
+    struct Q15 {};
+
+/**
+ * @struct Q31
+ * @brief Scalar tag for 32-bit fixed point: a Q31 fraction of +-ACCEL_MAX_RANGE_G, 1 LSB = 8 / 2^31 g.
+ *
+ * Holds every sample exactly with 16 bits to spare, e.g. for filters and accumulators.
+ */
+    struct Q31 {};
+
+/**
+ * @namespace FixedPoint
+ * @brief Integer helpers for the fixed-point scalar conversions.
+ */
+    namespace FixedPoint {
+
+        /**
+         * @brief Returns log2(ACCEL_MAX_RANGE_G / rangeG): the unused high bits of a count at a range.
+         * @param rangeG Full-scale range in g (2, 4 or 8).
+         * @return 2 for +-2 g, 1 for +-4 g, 0 for +-8 g.
+         */
+        constexpr unsigned int headroomBits(unsigned int rangeG) {
+            return (rangeG >= 8) ? 0 : (rangeG >= 4) ? 1 : 2;
+        }
+
+        /**
+         * @brief Clamps a value to the range of an integer type.
+         * @tparam T Destination type.
+         * @param value Value to clamp.
+         * @return value, or the nearest limit of T.
+         */
+        template <typename T>
+        constexpr T saturate(int64_t value) {
+            return (value > std::numeric_limits<T>::max()) ? std::numeric_limits<T>::max()
+                 : (value < std::numeric_limits<T>::min()) ? std::numeric_limits<T>::min()
+                 : static_cast<T>(value);
+        }
+
+        /**
+         * @brief Divides by 2^shift, rounding to nearest with halves rounded up.
+         * @param value Value to shift.
+         * @param shift Number of bits, at least 1.
+         * @return Rounded quotient.
+         */
+        constexpr int64_t roundingShift(int64_t value, unsigned int shift) {
+            return (value + (int64_t(1) << (shift - 1))) >> shift;
+        }
+
+    } // End of namespace FixedPoint
+
+/**
+ * @struct AccelerationScalar
+ * @brief Describes how a scalar type stores, scales and converts an acceleration component.
+ *
+ * Every specialization provides:
+ * - Storage: type of one component, Squared: exact type of x^2 + y^2 + z^2.
+ * - Scale and scaleForRange(): the per-range factor that turns a left-justified 16-bit reading into Storage.
+ * - fromCount(): converts one reading with that factor.
+ * - toQ31() / fromQ31(): converts to and from a Q31 fraction of +-ACCEL_MAX_RANGE_G, the common
+ *   format of BasicAccelerometer::convert(); rangeG only matters for raw counts.
+ * - add() / subtract(): component arithmetic, saturating for the integer types.
+ *
+ * @tparam Scalar float, int16_t, Q15 or Q31.
+ */
+    template <typename Scalar>
+    struct AccelerationScalar;
+
+/**
+ * @brief Acceleration in g as float.
+ */
+    template <>
+    struct AccelerationScalar<float> {
+        using Storage = float; /**< Component in g. */
+        using Squared = float; /**< Squared magnitude in g^2. */
+        using Scale = float;   /**< g per count of a left-justified 16-bit reading. */
+
+        static constexpr Scale scaleForRange(unsigned int rangeG) {
+            return static_cast<float>(rangeG) / 32768.0f;
+        }
+
+        static constexpr Storage fromCount(int16_t count, Scale scale) { return count * scale; }
+
+        static constexpr int32_t toQ31(Storage value, unsigned int) {
+            const float scaled = value * (float(1u << 31) / ACCEL_MAX_RANGE_G);
+            return !(scaled == scaled) ? 0 // NaN
+                 : (scaled >= 2147483648.0f) ? std::numeric_limits<int32_t>::max()
+                 : (scaled <= -2147483648.0f) ? std::numeric_limits<int32_t>::min()
+                 : static_cast<int32_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+        }
+
+        static constexpr Storage fromQ31(int32_t value, unsigned int) {
+            return value * (ACCEL_MAX_RANGE_G / float(1u << 31));
+        }
+
+        static constexpr Squared square(Storage value) { return value * value; }
+
+        static constexpr Storage add(Storage a, Storage b) { return a + b; }
+
+        static constexpr Storage subtract(Storage a, Storage b) { return a - b; }
+    };
+
+/**
+ * @brief Raw sensor counts: the left-justified 16-bit reading at the active range (+-32768 = full scale).
+ */
+    template <>
+    struct AccelerationScalar<int16_t> {
+        using Storage = int16_t;  /**< Reading as received. */
+        using Squared = uint32_t; /**< Up to 3 * 2^30. */
+        using Scale = uint8_t;    /**< Unused: counts are kept as read. */
+
+        static constexpr Scale scaleForRange(unsigned int) { return 0; }
+
+        static constexpr Storage fromCount(int16_t count, Scale) { return count; }
+
+        static constexpr int32_t toQ31(Storage value, unsigned int rangeG) {
+            return int32_t(value) * (int32_t(1) << (16 - FixedPoint::headroomBits(rangeG)));
+        }
+
+        static constexpr Storage fromQ31(int32_t value, unsigned int rangeG) {
+            return FixedPoint::saturate<int16_t>(FixedPoint::roundingShift(value, 16 - FixedPoint::headroomBits(rangeG)));
+        }
+
+        static constexpr Squared square(Storage value) { return static_cast<Squared>(int32_t(value) * value); }
+
+        static constexpr Storage add(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) + b); }
+
+        static constexpr Storage subtract(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) - b); }
+    };
+
+/**
+ * @brief 16-bit fixed point, see Q15.
+ */
+    template <>
+    struct AccelerationScalar<Q15> {
+        using Storage = int16_t;  /**< Q15 fraction of +-8 g. */
+        using Squared = uint32_t; /**< Up to 3 * 2^30. */
+        using Scale = uint8_t;    /**< Right shift from a reading, headroomBits() of the range. */
+
+        static constexpr Scale scaleForRange(unsigned int rangeG) {
+            return static_cast<Scale>(FixedPoint::headroomBits(rangeG));
+        }
+
+        // Exact for 14-bit and 8-bit readings, whose dropped low bits are zero
+        static constexpr Storage fromCount(int16_t count, Scale scale) { return static_cast<Storage>(count >> scale); }
+
+        static constexpr int32_t toQ31(Storage value, unsigned int) { return int32_t(value) * 65536; }
+
+        static constexpr Storage fromQ31(int32_t value, unsigned int) {
+            return FixedPoint::saturate<Storage>(FixedPoint::roundingShift(value, 16));
+        }
+
+        static constexpr Squared square(Storage value) { return static_cast<Squared>(int32_t(value) * value); }
+
+        static constexpr Storage add(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) + b); }
+
+        static constexpr Storage subtract(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) - b); }
+    };
+
+/**
+ * @brief 32-bit fixed point, see Q31.
+ */
+    template <>
+    struct AccelerationScalar<Q31> {
+        using Storage = int32_t;  /**< Q31 fraction of +-8 g. */
+        using Squared = uint64_t; /**< Up to 3 * 2^62. */
+        using Scale = uint8_t;    /**< Left shift from a reading, 16 - headroomBits() of the range. */
+
+        static constexpr Scale scaleForRange(unsigned int rangeG) {
+            return static_cast<Scale>(16 - FixedPoint::headroomBits(rangeG));
+        }
+
+        static constexpr Storage fromCount(int16_t count, Scale scale) { return int32_t(count) * (int32_t(1) << scale); }
+
+        static constexpr int32_t toQ31(Storage value, unsigned int) { return value; }
+
+        static constexpr Storage fromQ31(int32_t value, unsigned int) { return value; }
+
+        static constexpr Squared square(Storage value) { return static_cast<Squared>(int64_t(value) * value); }
+
+        static constexpr Storage add(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) + b); }
+
+        static constexpr Storage subtract(Storage a, Storage b) { return FixedPoint::saturate<Storage>(int64_t(a) - b); }
+    };
+
+/**
+ * @class BasicAccelerometer
+ * @brief Represents one accelerometer sample and provides methods for parsing and computations.
+ *
+ * The float instantiation (Accelerometer) holds g values for the PC application. RawAccelerometer
+ * keeps the sensor counts in 6 bytes, AccelerometerQ15 and AccelerometerQ31 hold range-independent
+ * fixed point, all without floating-point arithmetic. Integer sums and differences saturate, and
+ * the magnitude ordering is exact for them; the float ordering keeps a 1e-5 g tolerance for <= and >=.
+ *
+ * @tparam Scalar float, int16_t, Q15 or Q31, see AccelerationScalar.
+ */
+    template <typename Scalar>
+    class BasicAccelerometer {
+    public:
+        using Traits = AccelerationScalar<Scalar>;        /**< Conversions and arithmetic of Scalar. */
+        using value_type = typename Traits::Storage;      /**< Type of one component. */
+        using squared_type = typename Traits::Squared;    /**< Type of squaredMagnitude(). */
+        using scale_type = typename Traits::Scale;        /**< Type of scaleForRange(). */
+
+        static constexpr double MAGNITUDE_TOLERANCE = 1e-5; /**< Float magnitudes closer than this compare equal for <= and >=. */
+
+    private:
+        value_type x; /**< X-axis acceleration. */
+        value_type y; /**< Y-axis acceleration. */
+        value_type z; /**< Z-axis acceleration. */
+
+        /**
+         * @brief Returns the squared magnitude used for ordering: exact for every scalar.
+         *
+         * Float components are squared in double, where their products are exact, so nearly
+         * equal magnitudes still order correctly; integer ones already have an exact squared_type.
+         */
+        static constexpr auto orderKey(const BasicAccelerometer &accel) {
+            if constexpr (std::is_floating_point<value_type>::value) {
+                const double dx = accel.x, dy = accel.y, dz = accel.z;
+                return dx * dx + dy * dy + dz * dz;
+            } else {
+                return accel.squaredMagnitude();
+            }
+        }
+
+        /**
+         * @brief Tests |a| <= |b|, within MAGNITUDE_TOLERANCE for floats, from squared magnitudes only.
+         *
+         * For floats, squaring both non-negative sides of |a| <= |b| + t gives A - B - t^2 <= 2 t |b|,
+         * which is squared once more when the left side is positive.
+         */
+        static constexpr bool magnitudeAtMost(const BasicAccelerometer &a, const BasicAccelerometer &b) {
+            const auto squaredA = orderKey(a);
+            const auto squaredB = orderKey(b);
+            if constexpr (std::is_floating_point<value_type>::value) {
+                if (squaredA <= squaredB) {
+                    return true;
+                }
+                const double excess = squaredA - squaredB - MAGNITUDE_TOLERANCE * MAGNITUDE_TOLERANCE;
+                return excess <= 0.0 || excess * excess <= 4.0 * MAGNITUDE_TOLERANCE * MAGNITUDE_TOLERANCE * squaredB;
+            } else {
+                return squaredA <= squaredB;
+            }
+        }
+
+    public:
+        /**
+         * @brief Default constructor initializing acceleration to zero.
+         */
+        constexpr BasicAccelerometer() : x(), y(), z() {}
+
+        /**
+         * @brief Parameterized constructor initializing acceleration to given values.
+         * @param x X-axis acceleration.
+         * @param y Y-axis acceleration.
+         * @param z Z-axis acceleration.
+         */
+        constexpr BasicAccelerometer(value_type x, value_type y, value_type z) : x(x), y(y), z(z) {}
+
+        /**
+         * @brief Copy constructor initializing acceleration by copying of the another Accelerometer objet.
+         *
+         * Defaulted, so the type stays trivially copyable and arrays of samples can be copied as bytes.
+         */
+        constexpr BasicAccelerometer(const BasicAccelerometer &other) = default;
+
+        /**
+         * @brief Copy assignment, defaulted like the copy constructor.
+         */
+        constexpr BasicAccelerometer &operator=(const BasicAccelerometer &other) = default;
+
+        /**
+         * @brief Sets the X-asis acceleration.
+         * @param x_val New value of X-axis acceleration.
+         */
+        constexpr void setX(value_type x_val) {
+            x = x_val;
+        }
+
+        /**
+         * @brief Sets the Y-asis acceleration.
+         * @param y_val New value of Y-axis acceleration.
+         */
+        constexpr void setY(value_type y_val) {
+            y = y_val;
+        }
+
+        /**
+         * @brief Sets the Z-asis acceleration.
+         * @param z_val New value of Z-axis acceleration.
+         */
+        constexpr void setZ(value_type z_val) {
+            z = z_val;
+        }
+
+        /**
+         * @brief Returns the X-axis acceleration.
+         * @return X-axis acceleration in the units of Scalar.
+         */
+        constexpr value_type getX() const { return x; }
+
+        /**
+         * @brief Returns the Y-axis acceleration.
+         * @return Y-axis acceleration in the units of Scalar.
+         */
+        constexpr value_type getY() const { return y; }
+
+        /**
+         * @brief Returns the Z-axis acceleration.
+         * @return Z-axis acceleration in the units of Scalar.
+         */
+        constexpr value_type getZ() const { return z; }
+
+        /**
+         * @brief Returns the factor from a left-justified 16-bit reading to value_type for a full-scale range.
+         * @param rangeG Full-scale range in g (2, 4 or 8).
+         * @return g per count for float, a shift for the fixed-point scalars, unused for raw counts.
+         */
+        static constexpr scale_type scaleForRange(unsigned int rangeG) {
+            return Traits::scaleForRange(rangeG);
+        }
+
+        /**
+         * @brief Builds a sample from three left-justified 16-bit readings.
+         * @param countX X-axis reading (countY and countZ likewise).
+         * @param scale Scale of the active full-scale range, see scaleForRange().
+         * @return Sample in the units of Scalar.
+         */
+        static constexpr BasicAccelerometer fromCounts(int16_t countX, int16_t countY, int16_t countZ,
+                                                       scale_type scale = scaleForRange(2)) {
+            return BasicAccelerometer(Traits::fromCount(countX, scale), Traits::fromCount(countY, scale),
+                                      Traits::fromCount(countZ, scale));
+        }
+
+        /**
+         * @brief Parses raw accelerometer data and scales it, without allocating.
+         * @param rawData 6 bytes (14-bit X/Y/Z, MSB first) or 3 bytes (8-bit fast-read X/Y/Z MSBs).
+         * @param length Number of bytes at rawData.
+         * @param scale Scale of the active full-scale range, see scaleForRange().
+         * @return True if parsing was successful, otherwise false.
+         */
+        constexpr bool parseRawData(const uint8_t *rawData, size_t length, scale_type scale = scaleForRange(2)) {
+            if (length < 3 || (length > 3 && length < 6)) {
+                return false;
+            }
+
+            if (length == 3) {
+                // 8-bit fast-read layout: only the MSB of each axis, so it is the high byte of the 16-bit value
+                *this = fromCounts(static_cast<int16_t>(rawData[0] << 8), static_cast<int16_t>(rawData[1] << 8),
+                                   static_cast<int16_t>(rawData[2] << 8), scale);
+            } else {
+                // 6 bytes, each axis is represented by 2 bytes (big-endian format)
+                *this = fromCounts(static_cast<int16_t>((rawData[0] << 8) | rawData[1]),
+                                   static_cast<int16_t>((rawData[2] << 8) | rawData[3]),
+                                   static_cast<int16_t>((rawData[4] << 8) | rawData[5]), scale);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Parses raw accelerometer data held in a contiguous container (std::array, std::vector).
+         * @tparam Container Type with data() and size().
+         * @param rawData Raw sample bytes.
+         * @param scale Scale of the active full-scale range, see scaleForRange().
+         * @return True if parsing was successful, otherwise false.
+         */
+        template <typename Container>
+        constexpr auto parseRawData(const Container &rawData, scale_type scale = scaleForRange(2))
+                -> decltype(rawData.data(), rawData.size(), bool()) {
+            return parseRawData(rawData.data(), rawData.size(), scale);
+        }
+
+        /**
+         * @brief Writes the counts in the sensor's byte layout, the inverse of parseRawData() (RawAccelerometer only).
+         * @param rawData Destination: 6 bytes (X/Y/Z, MSB first) or 3 bytes (8-bit fast-read X/Y/Z MSBs).
+         * @param length 6 or 3.
+         * @return False for any other length; nothing is written then.
+         */
+        constexpr bool writeRawData(uint8_t *rawData, size_t length) const {
+            static_assert(std::is_same<Scalar, int16_t>::value, "Only raw counts have a byte layout");
+            if (length != 6 && length != 3) {
+                return false;
+            }
+
+            const value_type counts[3] = {x, y, z};
+            for (size_t i = 0; i < 3; ++i) {
+                const uint16_t bits = static_cast<uint16_t>(counts[i]);
+                if (length == 3) {
+                    rawData[i] = static_cast<uint8_t>(bits >> 8);
+                } else {
+                    rawData[2 * i] = static_cast<uint8_t>(bits >> 8);
+                    rawData[2 * i + 1] = static_cast<uint8_t>(bits & 0xFF);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Converts the sample to another scalar type through Q31, saturating values it cannot hold.
+         * @tparam Target Destination scalar.
+         * @param rangeG Full-scale range of raw counts, on either side (2, 4 or 8).
+         * @return Converted sample.
+         */
+        template <typename Target>
+        constexpr BasicAccelerometer<Target> convert(unsigned int rangeG = 2) const {
+            if constexpr (std::is_same<Target, Scalar>::value) {
+                return *this;
+            } else {
+                using TargetTraits = AccelerationScalar<Target>;
+                return BasicAccelerometer<Target>(TargetTraits::fromQ31(Traits::toQ31(x, rangeG), rangeG),
+                                                  TargetTraits::fromQ31(Traits::toQ31(y, rangeG), rangeG),
+                                                  TargetTraits::fromQ31(Traits::toQ31(z, rangeG), rangeG));
+            }
+        }
+
+        /**
+         * @brief Prints the accelerometer values in a formatted manner (defined in AccelerometerClass.hpp).
+         */
+        void print() const;
+
+        /**
+         * @brief Computes the magnitude of the acceleration vector (floating-point scalars only).
+         * @return Magnitude (sqrt(x^2 + y^2 + z^2)).
+         */
+        template <typename S = Scalar, typename = std::enable_if_t<std::is_floating_point<S>::value>>
+        value_type magnitude() const {
+            return std::sqrt(squaredMagnitude());
+        }
+
+        /**
+         * @brief Computes the squared magnitude, which orders vectors like magnitude() without a sqrt.
+         * @return x^2 + y^2 + z^2, exact for the integer scalars.
+         */
+        constexpr squared_type squaredMagnitude() const {
+            return Traits::square(x) + Traits::square(y) + Traits::square(z);
+        }
+
+        // Operator overloads (ordering compares magnitudes, computed without sqrt)
+        constexpr BasicAccelerometer operator+(const BasicAccelerometer &other) const {
+            return BasicAccelerometer(Traits::add(x, other.x), Traits::add(y, other.y), Traits::add(z, other.z));
+        }
+
+        constexpr BasicAccelerometer &operator+=(const BasicAccelerometer &other) {
+            return *this = *this + other;
+        }
+
+        constexpr BasicAccelerometer operator-(const BasicAccelerometer &other) const {
+            return BasicAccelerometer(Traits::subtract(x, other.x), Traits::subtract(y, other.y),
+                                      Traits::subtract(z, other.z));
+        }
+
+        constexpr BasicAccelerometer &operator-=(const BasicAccelerometer &other) {
+            return *this = *this - other;
+        }
+
+        constexpr bool operator==(const BasicAccelerometer &other) const {
+            return (x == other.x && y == other.y && z == other.z); // Compare all components
+        }
+
+        constexpr bool operator!=(const BasicAccelerometer &other) const {
+            return !(*this == other); // Negate equality
+        }
+
+        constexpr bool operator<(const BasicAccelerometer &other) const {
+            return orderKey(*this) < orderKey(other); // Compare magnitudes
+        }
+
+        constexpr bool operator<=(const BasicAccelerometer &other) const {
+            return magnitudeAtMost(*this, other);
+        }
+
+        constexpr bool operator>(const BasicAccelerometer &other) const {
+            return orderKey(*this) > orderKey(other);
+        }
+
+        constexpr bool operator>=(const BasicAccelerometer &other) const {
+            return magnitudeAtMost(other, *this);
+        }
+    };
+
+    using Accelerometer = BasicAccelerometer<float>;       /**< Acceleration in g (PC application). */
+    using RawAccelerometer = BasicAccelerometer<int16_t>;  /**< Sensor counts at the active range, 6 bytes. */
+    using AccelerometerQ15 = BasicAccelerometer<Q15>;      /**< 16-bit fixed point, 6 bytes. */
+    using AccelerometerQ31 = BasicAccelerometer<Q31>;      /**< 32-bit fixed point, 12 bytes. */
+
+    static_assert(sizeof(RawAccelerometer) == 6 && sizeof(AccelerometerQ15) == 6 && sizeof(AccelerometerQ31) == 12,
+                  "Samples must stay packed: arrays of them are copied to and from the wire as bytes");
+    static_assert(std::is_trivially_copyable<RawAccelerometer>::value, "Samples must be copyable as bytes");
+
+    // 1 g at +-2 g: 0x4000 counts, 0x1000 in Q15; the Q15 -> Q31 -> counts round-trip is exact
+    static_assert(AccelerometerQ15(0x1000, -0x1000, 0x0401).convert<Q31>().convert<int16_t>(2)
+                  == RawAccelerometer(0x4000, -0x4000, 0x1004), "Q15 -> Q31 -> int16 round-trip");
+    static_assert(RawAccelerometer(0x4000, -0x4000, 0x1004).convert<Q15>(2) == AccelerometerQ15(0x1000, -0x1000, 0x0401),
+                  "int16 -> Q31 -> Q15 round-trip");
+    static_assert(AccelerometerQ31(std::numeric_limits<int32_t>::max(), 0, 0).convert<int16_t>(2).getX()
+                  == std::numeric_limits<int16_t>::max(), "Conversions saturate");
+
+} // End of namespace
+
+#endif // BASIC_ACCELEROMETER_HPP
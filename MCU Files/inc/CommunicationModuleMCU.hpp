@@ -15,6 +15,9 @@
 #include <cstring>
 
 #include "CommunicationModuleBase.hpp"
+#include "CommandHash.hpp"
+#include "MMA8451.hpp"
+#include "TextWriter.hpp"
 
 /**
  * @class CommunicationModuleMCU
@@ -27,9 +30,282 @@ namespace mb {
 class CommunicationModuleMCU : public CommunicationModule
 {
 private:
-    static constexpr size_t BUFFER_SIZE = 64; /**< Size of the local buffer. */
-    char buffer[BUFFER_SIZE];                 /**< Local buffer for received data. */
-    volatile bool dataReady = false;          /**< Flag indicating new data availability. */
+    static constexpr size_t BUFFER_SIZE = 64; /**< Size of one received line slot. */
+    static constexpr uint8_t RX_SLOTS = 8;    /**< Lines that can wait for handling, a power of two. */
+    static_assert((RX_SLOTS & (RX_SLOTS - 1)) == 0, "RX_SLOTS must be a power of two");
+
+    // Lock-free queue of complete lines: the UART interrupt fills slot rxHead and publishes
+    // it by advancing rxHead, the main loop handles slot rxTail. Indices run freely and wrap.
+    char rxSlots[RX_SLOTS][BUFFER_SIZE];      /**< Received lines (commands or binary frames). */
+    volatile uint8_t rxHead = 0;              /**< Slot being filled (written by the interrupt only). */
+    volatile uint8_t rxTail = 0;              /**< Oldest unhandled slot (written by the main loop only). */
+    size_t rxLength = 0;                      /**< Characters stored in slot rxHead (interrupt only). */
+    bool rxDiscarding = false;                /**< True while dropping a line that arrived with all slots full. */
+    bool rxClaimed = false;                   /**< True while slot rxTail is handed out by receiveData(). */
+    char replyTag[4] = {};                    /**< "#XX" tag of the command being handled, empty if untagged. */
+    volatile bool binaryMode = false;         /**< True after SET_BINARY_MODE: input is 0x00-delimited COBS frames. */
+    MMA8451 accelerometer;                    /**< On-board accelerometer, capturing from init() on. */
+
+    /**
+     * @struct Subscription
+     * @brief Push schedule of one sensor stream.
+     */
+    struct Subscription
+    {
+        uint8_t sensor;       /**< Binary ID of the sensor's read command (BIN_READ_*). */
+        const char* name;     /**< Text name of the sensor's read command. */
+        uint16_t periodMs;    /**< Sample period in milliseconds, 0 while the stream is off. */
+        uint32_t nextDueMs;   /**< millis() value at which the next sample is due. */
+    };
+
+    static constexpr size_t STREAM_COUNT = 3;       /**< Number of streamable sensors. */
+    static constexpr size_t STREAM_TX_RESERVE = 64; /**< Free transmit ring space needed to send a sample. */
+    Subscription subscriptions[STREAM_COUNT] = {
+        { BIN_READ_ACCELERATION, READ_ACCELERATION, 0, 0 },
+        { BIN_READ_TEMPERATURE,  READ_TEMPERATURE,  0, 0 },
+        { BIN_READ_TOUCH,        READ_TOUCH,        0, 0 },
+    };
+
+    static constexpr uint32_t ACCEL_STALE_MS = 1000; /**< Age after which the newest captured sample means the capture stalled. */
+    static constexpr size_t ACCEL_BATCH_SIZE = 1 + MMA8451::RING_SIZE * MMA8451::SAMPLE_SIZE; /**< Count byte plus a full capture ring. */
+    uint8_t accelBatch[ACCEL_BATCH_SIZE];      /**< Last ring drain in the BIN_READ_ACCEL_BATCH data layout. */
+
+    /**
+     * @brief Executes a single command without any tag handling.
+     *        The command word is looked up in COMMANDS through a compile-time perfect hash.
+     * @param cmd Pointer to the null-terminated command string.
+     */
+    void executeCommand(const char* cmd);
+
+    /**
+     * @brief Answers PING with PONG.
+     */
+    void commandPing(const char* args);
+
+    /**
+     * @brief Acknowledges and resets the MCU.
+     */
+    void commandReset(const char* args);
+
+    /**
+     * @brief Sends the board name and the unique ID.
+     */
+    void commandReadInfo(const char* args);
+
+    /**
+     * @brief Sends the internal temperature.
+     */
+    void commandReadTemperature(const char* args);
+
+    /**
+     * @brief Sends the touch slider position.
+     */
+    void commandReadTouch(const char* args);
+
+    /**
+     * @brief Recalibrates the touch slider.
+     */
+    void commandSetTouch(const char* args);
+
+    /**
+     * @brief Switches the RGB LED to red.
+     */
+    void commandSetLedRed(const char* args);
+
+    /**
+     * @brief Switches the RGB LED to green.
+     */
+    void commandSetLedGreen(const char* args);
+
+    /**
+     * @brief Switches the RGB LED to blue.
+     */
+    void commandSetLedBlue(const char* args);
+
+    /**
+     * @brief Sends the newest raw accelerometer sample (six bytes, or three in 8-bit mode).
+     */
+    void commandReadAcceleration(const char* args);
+
+    /**
+     * @brief Drains the captured accelerometer samples and sends them as a header line plus one line per sample.
+     */
+    void commandReadAccelerationBatch(const char* args);
+
+    /**
+     * @brief Selects 8-bit fast-read or 14-bit accelerometer samples ("8" or "14").
+     */
+    void commandSetAccelerationResolution(const char* args);
+
+    /**
+     * @brief Selects the accelerometer full-scale range ("2", "4" or "8" g) and reports it.
+     */
+    void commandSetAccelerationRange(const char* args);
+
+    /**
+     * @brief Reports the active accelerometer full-scale range.
+     */
+    void commandReadAccelerationRange(const char* args);
+
+    /**
+     * @brief Acknowledges and enters the binary protocol.
+     */
+    void commandBinaryMode(const char* args);
+
+    /**
+     * @brief Starts or re-times a sensor stream ("<sensor> <periodMs>").
+     */
+    void commandSubscribe(const char* args);
+
+    /**
+     * @brief Stops one sensor stream, or all of them without arguments.
+     */
+    void commandUnsubscribe(const char* args);
+
+    /**
+     * @struct CommandEntry
+     * @brief One text command: its first word and the member function that handles it.
+     */
+    struct CommandEntry
+    {
+        const char* name;                                       /**< Command word. */
+        void (CommunicationModuleMCU::*handler)(const char* args); /**< Handler, receives the text after the word. */
+    };
+
+    /**
+     * @brief Text commands understood by executeCommand(); adding a command is one entry here.
+     */
+    static constexpr CommandEntry COMMANDS[] = {
+        { PING,                &CommunicationModuleMCU::commandPing },
+        { RESET,               &CommunicationModuleMCU::commandReset },
+        { GET_SYSTEM_INFO,     &CommunicationModuleMCU::commandReadInfo },
+        { READ_TEMPERATURE,    &CommunicationModuleMCU::commandReadTemperature },
+        { READ_TOUCH,          &CommunicationModuleMCU::commandReadTouch },
+        { SET_TOUCH,           &CommunicationModuleMCU::commandSetTouch },
+        { SET_LED_COLOR_RED,   &CommunicationModuleMCU::commandSetLedRed },
+        { SET_LED_COLOR_GREEN, &CommunicationModuleMCU::commandSetLedGreen },
+        { SET_LED_COLOR_BLUE,  &CommunicationModuleMCU::commandSetLedBlue },
+        { READ_ACCELERATION,   &CommunicationModuleMCU::commandReadAcceleration },
+        { READ_ACCEL_BATCH,    &CommunicationModuleMCU::commandReadAccelerationBatch },
+        { SET_ACCEL_RES,       &CommunicationModuleMCU::commandSetAccelerationResolution },
+        { SET_ACCEL_RANGE,     &CommunicationModuleMCU::commandSetAccelerationRange },
+        { READ_ACCEL_RANGE,    &CommunicationModuleMCU::commandReadAccelerationRange },
+        { SET_BINARY_MODE,     &CommunicationModuleMCU::commandBinaryMode },
+        { SUBSCRIBE,           &CommunicationModuleMCU::commandSubscribe },
+        { UNSUBSCRIBE,         &CommunicationModuleMCU::commandUnsubscribe },
+    };
+
+    static constexpr size_t COMMAND_SLOTS = 32; /**< Hash slots (power of two); enlarge if the static_assert below fires. */
+    static constexpr CommandHash::Table<COMMAND_SLOTS> COMMAND_HASH = CommandHash::build<COMMAND_SLOTS>(COMMANDS);
+    static_assert(COMMAND_HASH.valid, "Command names collide in the hash table: enlarge COMMAND_SLOTS");
+
+    /**
+     * @brief Decodes a binary request frame, executes it and sends the binary response.
+     * @param frame COBS-encoded frame without its delimiter (contains no 0x00 bytes).
+     */
+    void handleBinaryFrame(const char* frame);
+
+    /**
+     * @brief Handles "subscribe <sensor> <periodMs>" and "unsubscribe [sensor]".
+     * @param subscribe True for SUBSCRIBE, false for UNSUBSCRIBE.
+     * @param args Text following the command word.
+     */
+    void handleSubscription(bool subscribe, const char* args);
+
+    /**
+     * @brief Starts, re-times or (with a period of 0) stops a sensor stream.
+     * @param sensor Binary ID of the sensor's read command.
+     * @param periodMs Sample period in milliseconds, 0 to stop.
+     * @return False if the sensor cannot be streamed or the period is out of range.
+     */
+    bool setSubscription(uint8_t sensor, uint32_t periodMs);
+
+    /**
+     * @brief Reads one sensor sample as raw bytes, in the layout of the binary responses.
+     * @param sensor Binary ID of the sensor's read command.
+     * @param data Destination for up to 6 bytes.
+     * @return Number of bytes written, 0 for an unknown sensor or if no accelerometer sample is available.
+     */
+    size_t sampleSensor(uint8_t sensor, uint8_t* data);
+
+    /**
+     * @brief Copies the newest captured accelerometer sample, restarting a capture that failed or stalled.
+     * @param counts Output X/Y/Z counts.
+     * @param length Output size of the sample on the wire (6, or 3 in 8-bit mode), see RawAccelerometer::writeRawData().
+     * @return I2C::OK, I2C::PENDING if nothing was captured yet, or an I2C error code.
+     */
+    uint8_t latestAcceleration(RawAccelerometer& counts, size_t& length);
+
+    /**
+     * @brief Appends raw accelerometer bytes as space-separated decimal numbers.
+     * @tparam Writer TextWriter or another BasicTextWriter.
+     * @param text Line being assembled.
+     * @param xyz Raw sample bytes.
+     * @param length Number of bytes (6, or 3 in 8-bit mode).
+     */
+    template <typename Writer>
+    static void formatAcceleration(Writer& text, const uint8_t* xyz, size_t length);
+
+    /**
+     * @brief Appends a temperature as "<degrees>.<hundredths>C" using integer arithmetic only.
+     * @tparam Writer TextWriter or another BasicTextWriter.
+     * @param text Line being assembled.
+     * @param centiDegrees Temperature in hundredths of a degree Celsius.
+     */
+    template <typename Writer>
+    static void formatTemperature(Writer& text, int16_t centiDegrees);
+
+    /**
+     * @brief Sends "I2C error: <description>" as the reply to a failed command.
+     * @param status I2C::ERROR_* code.
+     */
+    void printI2CError(uint8_t status);
+
+    /**
+     * @brief Changes the accelerometer full-scale range, keeping data rate and oversampling.
+     * @param rangeG Range in g.
+     * @param status Output I2C::OK, or the I2C error code of the first failed transfer.
+     * @return False if rangeG is not 2, 4 or 8 (the sensor is then not accessed).
+     */
+    bool setAccelerationRange(uint32_t rangeG, uint8_t& status);
+
+    /**
+     * @brief Returns the active accelerometer full-scale range.
+     * @return Range in g: 2, 4 or 8.
+     */
+    uint8_t accelerationRangeG() const { return static_cast<uint8_t>(2u << static_cast<uint8_t>(accelerometer.getRange())); }
+
+    /**
+     * @brief Moves the captured accelerometer samples from the ring into accelBatch.
+     * @param length Output number of valid bytes in accelBatch (count byte plus samples).
+     * @return I2C::OK, or the I2C error code of a failed capture restart (length is then 0).
+     */
+    uint8_t readAccelerationBatch(size_t& length);
+
+    /**
+     * @brief Samples a sensor and pushes the result as a stream line or frame.
+     * @param subscription Stream to serve.
+     * @param timestampMs millis() value of the sample.
+     */
+    void sendStreamSample(const Subscription& subscription, uint32_t timestampMs);
+
+    /**
+     * @brief Encodes and transmits a binary frame.
+     * @param payload Payload to send.
+     * @param length Payload size in bytes (at most 3 + ACCEL_BATCH_SIZE).
+     */
+    void sendBinaryFrame(const uint8_t* payload, size_t length);
+
+    /**
+     * @brief Encodes and transmits a binary response frame.
+     * @param command Command ID of the request.
+     * @param sequence Sequence number of the request.
+     * @param status Status code (BIN_STATUS_*).
+     * @param data Response data, may be nullptr if length is 0.
+     * @param length Number of data bytes (at most ACCEL_BATCH_SIZE).
+     */
+    void sendBinaryResponse(uint8_t command, uint8_t sequence, uint8_t status,
+                            const uint8_t* data = nullptr, size_t length = 0);
 
 public:
     /**
@@ -38,7 +314,7 @@ public:
     CommunicationModuleMCU();
 
     /**
-     * @brief Initializes the higher-level communication (e.g., resets local buffer).
+     * @brief Initializes the higher-level communication (resets the receive queue, starts the accelerometer capture).
      */
     void init() override;
 
@@ -50,29 +326,49 @@ public:
 
     /**
      * @brief Sends a string via UART and appends \n\r.
+     *        While a tagged command is handled, every line is prefixed with "#XX:".
      * @param text Pointer to the string buffer.
      */
     void println(const char* text) override;
 
     /**
-     * @brief Blocks until data is ready and then returns a pointer to the received buffer.
-     * @return Pointer to the local buffer containing the received string.
+     * @brief Releases the line returned by the previous call, then blocks until the next line is queued.
+     * @return Pointer to the slot holding the received string, valid until the next call.
      */
     char* receiveData() override;
 
     /**
      * @brief Parses and executes commands received from the UART interface.
+     *        A command of the form "#XX cmd" is answered with "#XX:"-prefixed lines
+     *        followed by the "#XX." end marker, so the PC can match replies by tag.
      * @param cmd Pointer to the null-terminated command string.
      */
     void handleCommand(const char* cmd) override;
 
+    /**
+     * @brief Returns true if a complete command is waiting, so receiveData() would not block.
+     * @return Data ready state.
+     */
+    bool dataAvailable() const { return static_cast<uint8_t>(rxHead - rxTail) > (rxClaimed ? 1u : 0u); }
+
+    /**
+     * @brief Pushes a sample for every subscribed sensor whose period has elapsed.
+     *        Call it from the main loop between commands.
+     */
+    void serviceStreams();
+
     /**
      * @brief Called from the UART interrupt to store a received character.
+     *        A complete line is queued; if all slots are taken the whole line is dropped.
      * @param c Received character.
      */
     void onCharReceived(char c);
 		
 };
 
+// main() keeps the module in static storage next to the 1 KB stack, within 4 KB of RAM.
+// A new buffer that pushes it past this budget must be weighed against Stack_Size in the map.
+static_assert(sizeof(CommunicationModuleMCU) <= 2048, "CommunicationModuleMCU outgrew its 2 KB RAM budget");
+
 } // End of namespace mb
 #endif // COMMUNICATION_MODULE_MCU_HPP
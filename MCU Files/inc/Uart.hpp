@@ -12,6 +12,7 @@
 #define UART_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 extern "C" {
 #include "MKL05Z4.h"
@@ -27,14 +28,73 @@ class CommunicationModuleMCU;       // Forward declaration
 /**
  * @class Uart
  * @brief Class for initializing and handling UART0 transmissions and interrupts.
+ *
+ * Transmission is buffered: print() and println() copy the text into a ring buffer that
+ * UART0_IRQHandler drains one byte per TDRE interrupt, so the caller does not wait for the
+ * line. Only when the ring is full does print() wait for the interrupt to free space.
  */
 class Uart
 {
+public:
+    static constexpr size_t TX_BUFFER_SIZE = 256;  /**< Transmit ring size in bytes, a power of two. */
+
 private:
+    static_assert((TX_BUFFER_SIZE & (TX_BUFFER_SIZE - 1)) == 0, "TX_BUFFER_SIZE must be a power of two");
+
     uint32_t baudRate;                         /**< Baud rate for UART communication. */
     static CommunicationModuleMCU* g_commObject;/**< Pointer to the communication handler. */
+    static volatile uint8_t txBuffer[TX_BUFFER_SIZE]; /**< Bytes waiting for transmission. */
+    static volatile size_t txHead;             /**< Next free position (written by print()). */
+    static volatile size_t txTail;             /**< Next byte to send (written by the interrupt). */
+    static volatile bool txIdle;               /**< True once the last queued byte has left the shifter. */
 
 public:
+    /**
+     * @class TxSink
+     * @brief BasicTextWriter sink that formats straight into the transmit ring.
+     *
+     * Characters are stored in the free slots behind txHead, but txHead only moves in commit(),
+     * so the interrupt never sends part of a line and no intermediate buffer or copy is needed.
+     * The sink never waits: a line longer than the free space is dropped by commit(). Only one
+     * sink (or print()) may write at a time, which holds as long as it is used outside
+     * interrupts.
+     */
+    class TxSink
+    {
+    private:
+        size_t head;    /**< Ring position of the next character. */
+        size_t free;    /**< Free slots left behind head. */
+        bool overflow;  /**< True if a character did not fit. */
+
+    public:
+        /**
+         * @brief Starts a line at the current end of the queued data.
+         */
+        TxSink();
+
+        /**
+         * @brief Stores a character behind the queued data, without sending it yet.
+         * @param c Character to store.
+         */
+        void put(char c)
+        {
+            if (free == 0)
+            {
+                overflow = true;
+                return;
+            }
+            txBuffer[head] = static_cast<uint8_t>(c);
+            head = (head + 1) & (TX_BUFFER_SIZE - 1);
+            --free;
+        }
+
+        /**
+         * @brief Queues everything stored so far for transmission.
+         * @return False if the line did not fit; nothing was queued then.
+         */
+        bool commit();
+    };
+
     /**
      * @brief Default constructor, initializes UART with 9600 baud.
      */
@@ -64,22 +124,55 @@ public:
      */
     static void print(const char* text);
 
+    /**
+     * @brief Sends exactly length characters via UART (the text need not be null-terminated).
+     * @param text Pointer to the characters.
+     * @param length Number of characters to send.
+     */
+    static void print(const char* text, size_t length);
+
     /**
      * @brief Sends a null-terminated string via UART, then appends \n\r.
      * @param text Pointer to the string buffer.
      */
     static void println(const char* text);
 
+    /**
+     * @brief Queues the characters only if all of them fit, never waits.
+     * @param text Pointer to the characters.
+     * @param length Number of characters to send.
+     * @return False if the transmit ring is too full; nothing was queued then.
+     */
+    static bool tryPrint(const char* text, size_t length);
+
+    /**
+     * @brief Returns the free space in the transmit ring, for callers that prefer skipping to waiting.
+     * @return Number of bytes print() can queue without waiting.
+     */
+    static size_t txFree();
+
+    /**
+     * @brief Waits until every queued byte has been transmitted (e.g. before a reset).
+     */
+    static void flush();
+
 private:
     /**
-     * @brief Sends a single character in a blocking manner.
+     * @brief Queues a single character, waiting only while the transmit ring is full.
      * @param c Character to send.
      */
     static void sendChar(char c);
 
+    /**
+     * @brief Enables the transmit interrupt so the ring is drained.
+     */
+    static void startTransmit();
+
     /**
      * @brief Handles the UART interrupt, reads the received character,
      *        and forwards it to the communication handler if present.
+     *        Also feeds the next queued byte to the transmitter (TIE) and
+     *        detects the end of transmission (TCIE).
      */
     static void handleIRQ();
 
@@ -15,6 +15,43 @@
  * =========================================
  */
 
+namespace
+{
+    uint8_t scanChannels[ADC_MAX_SCAN_CHANNELS];          // Channels of the running scan
+    volatile uint16_t scanValues[ADC_MAX_SCAN_CHANNELS];  // Latest result per scanned channel
+    volatile uint8_t scanValid = 0;                       // Bit i set once scanValues[i] holds a result
+    volatile uint8_t scanCount = 0;                       // Number of scanned channels, 0 while stopped
+    volatile uint8_t scanIndex = 0;                       // Scanned channel being converted
+
+    /**
+     * @brief Starts converting the current scan channel with the completion interrupt enabled.
+     */
+    void startScanConversion()
+    {
+        ADC0->SC1[0] = ADC_SC1_AIEN_MASK | ADC_SC1_ADCH(scanChannels[scanIndex]);
+    }
+}
+
+extern "C" void ADC0_IRQHandler(void)
+{
+    uint16_t value = static_cast<uint16_t>(ADC0->R[0]); // Reading the result clears COCO
+    uint8_t index = scanIndex;
+    if (scanCount == 0)
+    {
+        return;
+    }
+
+    scanValues[index] = value;
+    scanValid = static_cast<uint8_t>(scanValid | (1u << index));
+
+    // Continuous mode already restarted the same channel; retarget it when cycling through several
+    if (scanCount > 1)
+    {
+        scanIndex = static_cast<uint8_t>((index + 1 == scanCount) ? 0 : index + 1);
+        startScanConversion();
+    }
+}
+
 uint8_t ADC_Init()
 {
     uint16_t kalib_temp;
@@ -52,22 +89,139 @@ uint8_t ADC_Init()
     return 0;
 }
 
+bool ADC_StartScan(const uint8_t* channels, uint8_t count, AdcAveraging averaging)
+{
+    if (count == 0 || count > ADC_MAX_SCAN_CHANNELS)
+    {
+        return false;
+    }
+
+    NVIC_DisableIRQ(ADC0_IRQn);
+    ADC0->SC1[0] = ADC_SC1_ADCH(31); // Abort a conversion of the previous scan
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        scanChannels[i] = channels[i];
+    }
+    scanCount = count;
+    scanIndex = 0;
+    scanValid = 0;
+
+    // With 32-sample averaging one result takes about 0.4 ms at the 3 MHz ADC clock,
+    // so the interrupt load stays small while every value is at most that old
+    ADC0->SC3 = ADC_SC3_ADCO_MASK | static_cast<uint8_t>(averaging);
+
+    NVIC_ClearPendingIRQ(ADC0_IRQn);
+    NVIC_EnableIRQ(ADC0_IRQn);
+    startScanConversion();
+    return true;
+}
+
+void ADC_StopScan()
+{
+    NVIC_DisableIRQ(ADC0_IRQn);
+    ADC0->SC1[0] = ADC_SC1_ADCH(31);
+    ADC0->SC3 &= ~ADC_SC3_ADCO_MASK; // Keep the averaging for single conversions
+    scanCount = 0;
+    scanValid = 0;
+}
+
+bool ADC_LatestValue(uint8_t channel, uint16_t& value)
+{
+    for (uint8_t i = 0; i < scanCount; ++i)
+    {
+        if (scanChannels[i] == channel && (scanValid & (1u << i)))
+        {
+            value = scanValues[i];
+            return true;
+        }
+    }
+    return false;
+}
+
 uint16_t ADC_ReadChannel(uint8_t channel)
 {
+    uint16_t value;
+    if (ADC_LatestValue(channel, value))
+    {
+        return value;
+    }
+
+    // Pause the scan for a single conversion of a channel it does not cover (or has not reached yet)
+    bool resume = (scanCount != 0);
+    uint32_t sc3 = ADC0->SC3;
+    if (resume)
+    {
+        NVIC_DisableIRQ(ADC0_IRQn);
+        ADC0->SC3 = sc3 & ~ADC_SC3_ADCO_MASK;
+    }
+
     ADC0->SC1[0] = ADC_SC1_ADCH(channel);
     while (!(ADC0->SC1[0] & ADC_SC1_COCO_MASK))
     {
         // Wait for conversion to complete
     }
-    return ADC0->R[0];
+    value = static_cast<uint16_t>(ADC0->R[0]);
+
+    if (resume)
+    {
+        ADC0->SC3 = sc3;
+        NVIC_ClearPendingIRQ(ADC0_IRQn);
+        NVIC_EnableIRQ(ADC0_IRQn);
+        startScanConversion();
+    }
+    return value;
+}
+
+namespace
+{
+    // Internal temperature sensor: VTEMP25 = 716 mV at 25 C, falling 1.62 mV/C, measured in
+    // 12-bit mode against a 2.91 V reference. All voltages in microvolts.
+    constexpr int64_t ADC_REFERENCE_UV    = 2910000;
+    constexpr int64_t ADC_FULL_SCALE      = 4095;
+    constexpr int64_t TEMP25_UV           = 716000;
+    constexpr int64_t TEMP_SLOPE_UV       = 1620;    // Per degree Celsius
+    constexpr int TEMP_FRACTION_BITS      = 12;
+
+    /**
+     * @brief Rounds a quotient of positive operands to the nearest integer.
+     * @param numerator Dividend.
+     * @param denominator Divisor.
+     * @return numerator / denominator, rounded half up.
+     */
+    constexpr int64_t roundedDivide(int64_t numerator, int64_t denominator)
+    {
+        return (2 * numerator + denominator) / (2 * denominator);
+    }
+
+    // centiDegrees = 2500 - (count * REF / FULL_SCALE - TEMP25) * 100 / SLOPE = OFFSET - count * STEP
+    constexpr int32_t TEMP_STEP_Q12 = static_cast<int32_t>(roundedDivide(
+        ADC_REFERENCE_UV * 100 << TEMP_FRACTION_BITS, ADC_FULL_SCALE * TEMP_SLOPE_UV));
+    constexpr int32_t TEMP_OFFSET_Q12 = static_cast<int32_t>(roundedDivide(
+        (2500 * TEMP_SLOPE_UV + TEMP25_UV * 100) << TEMP_FRACTION_BITS, TEMP_SLOPE_UV));
+
+    static_assert(ADC_FULL_SCALE * TEMP_STEP_Q12 <= INT32_MAX && TEMP_OFFSET_Q12 <= INT32_MAX,
+                  "Temperature conversion must not overflow 32-bit arithmetic");
 }
 
-float readTemperature()
+int16_t readTemperature()
 {
-    uint16_t adcValue = ADC_ReadChannel(26);
-    float voltage = (adcValue * 2.91f) / 4095.0f;
-    float result = 25.0f - (voltage - 0.716f) / 0.00162f;
-    return result;
+    int32_t count = ADC_ReadChannel(ADC_TEMPERATURE_CHANNEL);
+    int32_t scaled = TEMP_OFFSET_Q12 - count * TEMP_STEP_Q12;
+
+    // Round to the nearest hundredth; >> on a negative value is an arithmetic shift on Cortex-M
+    int32_t centiDegrees = (scaled + (1 << (TEMP_FRACTION_BITS - 1))) >> TEMP_FRACTION_BITS;
+
+    // Counts near either end of the scale (a faulty input, not a real die temperature) exceed int16_t
+    if (centiDegrees > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (centiDegrees < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(centiDegrees);
 }
 
 /* =========================================
@@ -107,29 +261,171 @@ void setLedColor(bool r, bool g, bool b)
 
 namespace I2C
 {
-    static inline uint8_t  error   = 0;
-    static inline uint16_t timeout = 0;
-
-    static void i2c_enable()   { I2C0->C1 |=  I2C_C1_IICEN_MASK; }
-    static void i2c_disable()  { I2C0->C1 &= ~I2C_C1_IICEN_MASK; }
-    static void i2c_m_start()  { I2C0->C1 |=  I2C_C1_MST_MASK; }
-    static void i2c_m_stop()   { I2C0->C1 &= ~I2C_C1_MST_MASK; }
-    static void i2c_m_rstart() { I2C0->C1 |=  I2C_C1_RSTA_MASK; }
-    static void i2c_tran()     { I2C0->C1 |=  I2C_C1_TX_MASK; }
-    static void i2c_rec()      { I2C0->C1 &= ~I2C_C1_TX_MASK; }
-    static void i2c_nack()     { I2C0->C1 |=  I2C_C1_TXAK_MASK; }
-    static void i2c_ack()      { I2C0->C1 &= ~I2C_C1_TXAK_MASK; }
-    static void i2c_send(uint8_t d) { I2C0->D = d; }
-    static uint8_t i2c_recv()       { return I2C0->D; }
-
-    static void i2c_wait()
-    {
-        timeout = 0;
-        while (!(I2C0->S & I2C_S_IICIF_MASK) && (timeout < 10000))
+    /**
+     * @brief Position of the transfer in progress within its bus sequence.
+     */
+    enum class Phase : uint8_t
+    {
+        ADDRESS_WRITE, // Device address + W sent, register address next
+        REGISTER,      // Register address sent, data (write) or repeated START (read) next
+        WRITE_DATA,    // Data byte sent
+        ADDRESS_READ,  // Device address + R sent, switch to receive
+        READ_DATA      // Data byte received
+    };
+
+    static constexpr uint16_t BUS_FREE_SPINS = 500; // Bound for the wait until a STOP has released the bus
+
+    static Transfer* volatile queue[QUEUE_SIZE];
+    static volatile uint8_t queueHead = 0;         // Free-running index of the next free slot
+    static volatile uint8_t queueTail = 0;         // Free-running index of the transfer in progress
+    static Transfer* volatile current = nullptr;   // Transfer in progress, nullptr while the bus is idle
+    static volatile Phase phase = Phase::ADDRESS_WRITE;
+    static volatile uint8_t index = 0;             // Next data byte of the current transfer
+    static volatile uint32_t lastEventMs = 0;      // millis() of the last bus event, for the timeout
+
+    static_assert((QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "QUEUE_SIZE must be a power of two");
+
+    static void startNext()
+    {
+        current = nullptr;
+        if (queueTail == queueHead)
+        {
+            return;
+        }
+
+        // A STOP issued just before needs a few microseconds to release the bus
+        for (uint16_t spin = 0; (I2C0->S & I2C_S_BUSY_MASK) && (spin < BUS_FREE_SPINS); ++spin)
         {
-            ++timeout;
         }
-        I2C0->S |= I2C_S_IICIF_MASK;
+
+        Transfer* transfer = queue[queueTail & (QUEUE_SIZE - 1)];
+        index = 0;
+        phase = Phase::ADDRESS_WRITE;
+        lastEventMs = millis();
+        current = transfer;
+
+        I2C0->C1 = I2C_C1_IICEN_MASK | I2C_C1_IICIE_MASK | I2C_C1_TX_MASK;
+        I2C0->C1 |= I2C_C1_MST_MASK; // START
+        I2C0->D = static_cast<uint8_t>(transfer->address << 1);
+    }
+
+    static void finish(uint8_t status)
+    {
+        Transfer* transfer = current;
+
+        I2C0->C1 &= ~(I2C_C1_MST_MASK | I2C_C1_TX_MASK | I2C_C1_TXAK_MASK); // STOP (if still bus master)
+        ++queueTail;
+        transfer->status = status;
+        if (transfer->onComplete)
+        {
+            transfer->onComplete(*transfer);
+        }
+        startNext();
+    }
+
+    static void handleIRQ()
+    {
+        uint8_t flags = I2C0->S;
+        I2C0->S = I2C_S_IICIF_MASK | I2C_S_ARBL_MASK; // Write-1-to-clear
+
+        Transfer* transfer = current;
+        if (transfer == nullptr)
+        {
+            return; // Late event of a transfer aborted by the timeout
+        }
+        lastEventMs = millis();
+
+        if (flags & I2C_S_ARBL_MASK)
+        {
+            finish(ERROR_ARBITRATION);
+            return;
+        }
+        if ((phase != Phase::READ_DATA) && (flags & I2C_S_RXAK_MASK))
+        {
+            finish(ERROR_NACK); // Every phase but READ_DATA ends with a byte sent by us
+            return;
+        }
+
+        switch (phase)
+        {
+            case Phase::ADDRESS_WRITE:
+                phase = Phase::REGISTER;
+                I2C0->D = transfer->reg;
+                break;
+
+            case Phase::REGISTER:
+                if (transfer->read)
+                {
+                    phase = Phase::ADDRESS_READ;
+                    I2C0->C1 |= I2C_C1_RSTA_MASK;
+                    I2C0->D = static_cast<uint8_t>((transfer->address << 1) | 1u);
+                    break;
+                }
+                phase = Phase::WRITE_DATA;
+                [[fallthrough]];
+
+            case Phase::WRITE_DATA:
+                if (index < transfer->size)
+                {
+                    I2C0->D = transfer->data[index++];
+                }
+                else
+                {
+                    finish(OK);
+                }
+                break;
+
+            case Phase::ADDRESS_READ:
+                phase = Phase::READ_DATA;
+                I2C0->C1 &= ~I2C_C1_TX_MASK;
+                if (transfer->size == 1)
+                {
+                    I2C0->C1 |= I2C_C1_TXAK_MASK;  // NACK the only byte
+                }
+                else
+                {
+                    I2C0->C1 &= ~I2C_C1_TXAK_MASK;
+                }
+                {
+                    uint8_t dummy = I2C0->D; // Dummy read clocks in the first byte
+                    (void)dummy;
+                }
+                break;
+
+            case Phase::READ_DATA:
+                if (index == transfer->size - 1)
+                {
+                    I2C0->C1 &= ~I2C_C1_MST_MASK; // STOP before reading D, so no further byte is clocked
+                    transfer->data[index++] = I2C0->D;
+                    finish(OK);
+                }
+                else
+                {
+                    if (index == transfer->size - 2)
+                    {
+                        I2C0->C1 |= I2C_C1_TXAK_MASK; // NACK the last byte
+                    }
+                    transfer->data[index++] = I2C0->D;
+                }
+                break;
+        }
+    }
+
+    /**
+     * @brief Aborts the transfer in progress if the bus has been silent for TIMEOUT_MS (SysTick context).
+     */
+    static void checkTimeout()
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq(); // The I2C interrupt may preempt SysTick
+
+        if ((current != nullptr) && ((millis() - lastEventMs) >= TIMEOUT_MS))
+        {
+            I2C0->C1 = 0; // Disabling the module resets its state machine and releases the bus
+            finish(ERROR_TIMEOUT);
+        }
+
+        __set_PRIMASK(primask);
     }
 
     void init()
@@ -142,86 +438,88 @@ namespace I2C
 
         I2C0->C1 &= ~I2C_C1_IICEN_MASK;
         I2C0->F = 0x03;
+        I2C0->C1 = I2C_C1_IICEN_MASK | I2C_C1_IICIE_MASK;
+
+        NVIC_ClearPendingIRQ(I2C0_IRQn);
+        NVIC_EnableIRQ(I2C0_IRQn);
+    }
+
+    bool submit(Transfer& transfer)
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq(); // Also called from completion callbacks in interrupt context
+
+        if (static_cast<uint8_t>(queueHead - queueTail) == QUEUE_SIZE)
+        {
+            __set_PRIMASK(primask);
+            transfer.status = ERROR_QUEUE_FULL;
+            return false;
+        }
+
+        transfer.status = PENDING;
+        queue[queueHead & (QUEUE_SIZE - 1)] = &transfer;
+        ++queueHead;
+        if (current == nullptr)
+        {
+            startNext();
+        }
+
+        __set_PRIMASK(primask);
+        return true;
+    }
+
+    uint8_t wait(const Transfer& transfer)
+    {
+        while (transfer.status == PENDING)
+        {
+            // Completed by I2C0_IRQHandler, or aborted by SysTick_Handler after TIMEOUT_MS
+        }
+        return transfer.status;
+    }
+
+    const char* statusText(uint8_t status)
+    {
+        switch (status)
+        {
+            case OK:                return "OK";
+            case ERROR_NACK:        return "NACK";
+            case ERROR_TIMEOUT:     return "timeout";
+            case ERROR_ARBITRATION: return "arbitration lost";
+            case ERROR_QUEUE_FULL:  return "queue full";
+            case PENDING:           return "pending";
+            default:                return "unknown";
+        }
     }
 
     uint8_t writeReg(uint8_t address, uint8_t reg, uint8_t data)
     {
-        error = 0;
-        i2c_enable();
-        i2c_tran();
-        i2c_m_start();
-        i2c_send(static_cast<uint8_t>(address << 1));
-        i2c_wait();
-        i2c_send(reg);
-        i2c_wait();
-        i2c_send(data);
-        i2c_wait();
-        i2c_m_stop();
-        i2c_disable();
-        return error;
+        Transfer transfer { address, reg, &data, 1, false };
+        submit(transfer);
+        return wait(transfer);
     }
 
     uint8_t readReg(uint8_t address, uint8_t reg, uint8_t* data)
     {
-        error = 0;
-        i2c_enable();
-        i2c_tran();
-        i2c_m_start();
-        i2c_send(static_cast<uint8_t>(address << 1));
-        i2c_wait();
-        i2c_send(reg);
-        i2c_wait();
-        i2c_m_rstart();
-        i2c_send(static_cast<uint8_t>((address << 1) | 1u));
-        i2c_wait();
-        i2c_rec();
-        i2c_nack();
-        (void)i2c_recv();
-        i2c_wait();
-        i2c_m_stop();
-        *data = i2c_recv();
-        i2c_disable();
-        return error;
+        return readRegBlock(address, reg, 1, data);
     }
 
     uint8_t readRegBlock(uint8_t address, uint8_t reg, uint8_t size, uint8_t* data)
     {
-        error = 0;
-        uint8_t dummy;
-        uint8_t cnt = 0;
-
-        i2c_enable();
-        i2c_tran();
-        i2c_m_start();
-        i2c_send(static_cast<uint8_t>(address << 1));
-        i2c_wait();
-        i2c_send(reg);
-        i2c_wait();
-        i2c_m_rstart();
-        i2c_send(static_cast<uint8_t>((address << 1) | 0x01));
-        i2c_wait();
-        i2c_rec();
-
-        while (cnt < (size - 1))
+        if (size == 0)
         {
-            i2c_ack();
-            dummy = i2c_recv();
-            (void)dummy;
-            i2c_wait();
-            data[cnt++] = i2c_recv();
+            return OK;
         }
-
-        i2c_nack();
-        dummy = i2c_recv();
-        (void)dummy;
-        i2c_wait();
-        i2c_m_stop();
-        data[cnt] = i2c_recv();
-        i2c_disable();
-        return error;
+        Transfer transfer { address, reg, data, size, true };
+        submit(transfer);
+        return wait(transfer);
     }
 } // End of namespace I2C
 
+extern "C" void I2C0_IRQHandler(void)
+{
+    I2C::handleIRQ();
+}
+
 /* =========================================
  * TSI (Touch Sensing) Functions
  * =========================================
@@ -332,3 +630,27 @@ extern "C" void TSI0_IRQHandler(void)
     TSI0->GENCS |= TSI_GENCS_EOSF_MASK;
     change_electrode();
 }
+
+/* =========================================
+ * SysTick (Time Base) Functions
+ * =========================================
+ */
+
+static volatile uint32_t msTicks = 0;
+
+void SysTick_Init()
+{
+    SystemCoreClockUpdate();
+    SysTick_Config(SystemCoreClock / 1000u);
+}
+
+uint32_t millis()
+{
+    return msTicks; // 32-bit loads are atomic on the Cortex-M0+
+}
+
+extern "C" void SysTick_Handler(void)
+{
+    msTicks++;
+    I2C::checkTimeout();
+}
@@ -10,8 +10,10 @@
 
 #include "../inc/CommunicationModuleMCU.hpp"
 #include "../inc/Uart.hpp"
-#include <cstdio>
+#include <cstdlib>
 #include "../inc/BoardSupport.hpp"
+#include "../inc/BinaryProtocol.hpp"
+#include "../inc/TextWriter.hpp"
 
 namespace mb { // Start of namespace mb
 
@@ -23,8 +25,13 @@ CommunicationModuleMCU::CommunicationModuleMCU()
 
 void CommunicationModuleMCU::init()
 {
-    std::memset(buffer, 0, sizeof(buffer));
-    dataReady = false;
+    std::memset(rxSlots, 0, sizeof(rxSlots));
+    rxLength = 0;
+    rxDiscarding = false;
+    rxClaimed = false;
+    rxTail = rxHead;
+    accelerometer.init();
+    accelerometer.startCapture(); // A failure is retried by the first read
 }
 
 void CommunicationModuleMCU::print(const char* text)
@@ -34,122 +41,787 @@ void CommunicationModuleMCU::print(const char* text)
 
 void CommunicationModuleMCU::println(const char* text)
 {
-    Uart::println(text);
+    if (replyTag[0] == '\0')
+    {
+        Uart::println(text);
+        return;
+    }
+
+    // Tagged reply: prefix every line of a (possibly multi-line) message
+    while (true)
+    {
+        const char* lineEnd = std::strchr(text, '\n');
+        size_t length = (lineEnd != nullptr) ? static_cast<size_t>(lineEnd - text) : std::strlen(text);
+
+        Uart::print(replyTag);
+        Uart::print(&TAG_LINE, 1);
+        Uart::print(text, length);
+        Uart::print("\n\r");
+
+        if (lineEnd == nullptr)
+        {
+            break;
+        }
+        text = lineEnd + 1;
+    }
 }
 
 char* CommunicationModuleMCU::receiveData()
 {
-    while (!dataReady)
+    if (rxClaimed)
+    {
+        rxTail = static_cast<uint8_t>(rxTail + 1); // The previous line was handled, free its slot
+        rxClaimed = false;
+    }
+
+    while (rxHead == rxTail)
     {
         // Wait until data is ready
     }
-    dataReady = false;
-    return buffer;
+    rxClaimed = true;
+    return rxSlots[rxTail & (RX_SLOTS - 1)];
+}
+
+static bool isHexDigit(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
 }
 
 void CommunicationModuleMCU::handleCommand(const char* cmd)
 {
-    if (std::strcmp(cmd, PING) == 0)
+    if (binaryMode)
+    {
+        handleBinaryFrame(cmd);
+        return;
+    }
+
+    // "#XX cmd": remember the tag, run the command, then close the reply with "#XX."
+    if (cmd[0] == TAG_MARKER && isHexDigit(cmd[1]) && isHexDigit(cmd[2]) && cmd[3] == ' ')
+    {
+        replyTag[0] = TAG_MARKER;
+        replyTag[1] = cmd[1];
+        replyTag[2] = cmd[2];
+        replyTag[3] = '\0';
+
+        executeCommand(cmd + 4);
+
+        Uart::print(replyTag);
+        Uart::print(&TAG_END, 1);
+        Uart::print("\n\r");
+        replyTag[0] = '\0';
+        return;
+    }
+
+    executeCommand(cmd);
+}
+
+void CommunicationModuleMCU::executeCommand(const char* cmd)
+{
+    // One hash, one slot read and one confirming compare, however many commands exist
+    const size_t length = CommandHash::wordLength(cmd);
+    const uint8_t index = COMMAND_HASH.find(cmd, length);
+
+    if (index == 0 || std::strncmp(COMMANDS[index - 1].name, cmd, length) != 0 || COMMANDS[index - 1].name[length] != '\0')
     {
-        println("PONG");
+        println("Unknown command");
+        return;
     }
-    else if (std::strcmp(cmd, RESET) == 0)
+
+    const char* args = cmd + length;
+    while (*args == ' ')
     {
-        println("System resetting...");
-        NVIC_SystemReset();
+        args++;
     }
-    else if (std::strcmp(cmd, GET_SYSTEM_INFO) == 0)
+    (this->*COMMANDS[index - 1].handler)(args);
+}
+
+void CommunicationModuleMCU::commandPing(const char*)
+{
+    println("PONG");
+}
+
+void CommunicationModuleMCU::commandReset(const char*)
+{
+    println("System resetting...");
+    Uart::flush(); // Let the reply leave the transmit ring before the reset
+    NVIC_SystemReset();
+}
+
+void CommunicationModuleMCU::commandReadInfo(const char*)
+{
+    char uidBuffer[50];
+    TextWriter(uidBuffer, sizeof(uidBuffer)).text("Device: FRDM-KL05ZJ\nUID: ").hex(SIM->UIDML).character('-').hex(SIM->UIDL);
+    println(uidBuffer);
+}
+
+void CommunicationModuleMCU::commandReadTemperature(const char*)
+{
+    char temperatureBuffer[12]; // Fits "-327.68C"
+    TextWriter text(temperatureBuffer, sizeof(temperatureBuffer));
+    formatTemperature(text, readTemperature());
+    println(temperatureBuffer);
+}
+
+void CommunicationModuleMCU::commandReadTouch(const char*)
+{
+    uint8_t sliderVal = TSI_ReadSlider();
+    char txt[15];
+    TextWriter(txt, sizeof(txt)).text("Slider = ").decimal(sliderVal).character('\r');
+    println(txt);
+}
+
+void CommunicationModuleMCU::commandSetTouch(const char*)
+{
+    println("TSI calibration...");
+    self_calibration();
+}
+
+void CommunicationModuleMCU::commandSetLedRed(const char*)
+{
+    setLedColor(true, false, false);
+    println("LED set to RED!");
+}
+
+void CommunicationModuleMCU::commandSetLedGreen(const char*)
+{
+    setLedColor(false, true, false);
+    println("LED set to GREEN!");
+}
+
+void CommunicationModuleMCU::commandSetLedBlue(const char*)
+{
+    setLedColor(false, false, true);
+    println("LED set to BLUE!");
+}
+
+void CommunicationModuleMCU::commandReadAcceleration(const char*)
+{
+    static char tempBuffer[36];
+    static uint8_t arrayXYZ[6];
+    RawAccelerometer counts;
+    size_t length = 0;
+
+    uint8_t status = latestAcceleration(counts, length);
+    if (status == I2C::PENDING)
+    {
+        println(ACCEL_NO_SAMPLE);
+        return;
+    }
+    if (status != I2C::OK)
+    {
+        printI2CError(status);
+        return;
+    }
+    counts.writeRawData(arrayXYZ, length);
+    TextWriter text(tempBuffer, sizeof(tempBuffer));
+    formatAcceleration(text, arrayXYZ, length);
+    println(tempBuffer);
+}
+
+void CommunicationModuleMCU::commandReadAccelerationBatch(const char*)
+{
+    char line[36];
+    size_t length = 0;
+
+    uint8_t status = readAccelerationBatch(length);
+    if (status != I2C::OK)
     {
-        char uidBuffer[50];
-        uint32_t uidMid = SIM->UIDML;
-        uint32_t uidLow = SIM->UIDL;
-        std::snprintf(uidBuffer, sizeof(uidBuffer), "Device: FRDM-KL05ZJ\nUID: %08X-%08X", uidMid, uidLow);
-        println(uidBuffer);
+        printI2CError(status);
+        return;
     }
-    else if (std::strcmp(cmd, READ_TEMPERATURE) == 0)
+
+    uint8_t count = accelBatch[0] & ~BIN_BATCH_OVERFLOW;
+    TextWriter(line, sizeof(line)).text(ACCEL_BATCH_HEADER).character(' ').decimal(count)
+        .text((accelBatch[0] & BIN_BATCH_OVERFLOW) ? " overflow" : "");
+    println(line);
+
+    size_t sampleSize = (count > 0) ? (length - 1) / count : 0;
+    for (uint8_t i = 0; i < count; ++i)
     {
-        float temperature = readTemperature();
-        char temperatureBuffer[10];
-        int intPart = static_cast<int>(temperature);
-        int fracPart = static_cast<int>((temperature - intPart) * 100);
-        std::snprintf(temperatureBuffer, sizeof(temperatureBuffer), "%d.%02dC", intPart, fracPart);
-        println(temperatureBuffer);
+        TextWriter text(line, sizeof(line));
+        formatAcceleration(text, accelBatch + 1 + i * sampleSize, sampleSize);
+        println(line);
     }
-    else if (std::strcmp(cmd, READ_TOUCH) == 0)
+}
+
+void CommunicationModuleMCU::commandSetAccelerationResolution(const char* args)
+{
+    char* end = nullptr;
+    unsigned long bits = std::strtoul(args, &end, 10);
+    if ((bits != 8 && bits != 14) || *end != '\0')
     {
-        uint8_t sliderVal = TSI_ReadSlider();
-        char txt[15];
-        std::sprintf(txt, "Slider = %u\r", sliderVal);
-        println(txt);
+        println("Invalid resolution");
+        return;
     }
-    else if (std::strcmp(cmd, SET_TOUCH) == 0)
+
+    uint8_t status = accelerometer.setFastRead(bits == 8);
+    if (status != I2C::OK)
     {
-        println("TSI calibration...");
-        self_calibration();
+        printI2CError(status);
+        return;
     }
-    else if (std::strcmp(cmd, SET_LED_COLOR_RED) == 0)
+    println(ACCEL_RES_ACK);
+}
+
+void CommunicationModuleMCU::commandSetAccelerationRange(const char* args)
+{
+    char* end = nullptr;
+    uint8_t status = I2C::OK;
+    unsigned long rangeG = std::strtoul(args, &end, 10);
+    if (*end != '\0' || !setAccelerationRange(rangeG, status))
     {
-        setLedColor(true, false, false);
-        println("LED set to RED!");
+        println("Invalid range");
+        return;
     }
-    else if (std::strcmp(cmd, SET_LED_COLOR_GREEN) == 0)
+    if (status != I2C::OK)
     {
-        setLedColor(false, true, false);
-        println("LED set to GREEN!");
+        printI2CError(status);
+        return;
     }
-    else if (std::strcmp(cmd, SET_LED_COLOR_BLUE) == 0)
+    commandReadAccelerationRange(args); // The new range is the acknowledgement
+}
+
+void CommunicationModuleMCU::commandReadAccelerationRange(const char*)
+{
+    char line[16];
+    TextWriter(line, sizeof(line)).text(ACCEL_RANGE_HEADER).character(' ').decimal(accelerationRangeG()).character('g');
+    println(line);
+}
+
+void CommunicationModuleMCU::commandBinaryMode(const char*)
+{
+    // Switch before acknowledging: the PC may send its first frame as soon as it sees the ACK
+    binaryMode = true;
+    println(BINARY_MODE_ACK);
+
+    // Close the trailing "\r" of the acknowledgement as an empty frame for the PC
+    const char delimiter = static_cast<char>(BinaryProtocol::FRAME_DELIMITER);
+    Uart::print(&delimiter, 1);
+}
+
+void CommunicationModuleMCU::commandSubscribe(const char* args)
+{
+    handleSubscription(true, args);
+}
+
+void CommunicationModuleMCU::commandUnsubscribe(const char* args)
+{
+    handleSubscription(false, args);
+}
+
+void CommunicationModuleMCU::handleSubscription(bool subscribe, const char* args)
+{
+    const char* nameEnd = std::strchr(args, ' ');
+    size_t nameLength = (nameEnd != nullptr) ? static_cast<size_t>(nameEnd - args) : std::strlen(args);
+
+    if (!subscribe && nameLength == 0)
     {
-        setLedColor(false, false, true);
-        println("LED set to BLUE!");
+        for (Subscription& subscription : subscriptions)
+        {
+            subscription.periodMs = 0; // "unsubscribe" alone stops every stream
+        }
+        println(UNSUBSCRIBE_ACK);
+        return;
     }
-    else if (std::strcmp(cmd, READ_ACCELERATION) == 0)
+
+    uint32_t periodMs = 0;
+    if (subscribe)
     {
-        I2C::writeReg(0x1D, 0x2A, 1);
-        I2C::writeReg(0x1D, 0x0E, 0x00);
+        char* periodEnd = nullptr;
+        periodMs = (nameEnd != nullptr) ? std::strtoul(nameEnd, &periodEnd, 10) : 0;
+        if (periodMs == 0 || *periodEnd != '\0')
+        {
+            println("Invalid period");
+            return;
+        }
+    }
 
-        static char tempBuffer[36];
-        static uint8_t arrayXYZ[6];
+    for (const Subscription& subscription : subscriptions)
+    {
+        if (std::strlen(subscription.name) == nameLength && std::strncmp(subscription.name, args, nameLength) == 0)
+        {
+            if (setSubscription(subscription.sensor, periodMs))
+            {
+                println(subscribe ? SUBSCRIBE_ACK : UNSUBSCRIBE_ACK);
+            }
+            else
+            {
+                println("Invalid period");
+            }
+            return;
+        }
+    }
+    println("Unknown sensor");
+}
 
-        I2C::readRegBlock(0x1D, 0x01, 6, arrayXYZ);
-        std::snprintf(tempBuffer,
-                      sizeof(tempBuffer),
-                      "%d %d %d %d %d %d",
-                      arrayXYZ[0],
-                      arrayXYZ[1],
-                      arrayXYZ[2],
-                      arrayXYZ[3],
-                      arrayXYZ[4],
-                      arrayXYZ[5]);
-        println(tempBuffer);
+bool CommunicationModuleMCU::setSubscription(uint8_t sensor, uint32_t periodMs)
+{
+    if (periodMs > MAX_STREAM_PERIOD_MS)
+    {
+        return false;
+    }
 
-        DELAY(300);
+    for (Subscription& subscription : subscriptions)
+    {
+        if (subscription.sensor == sensor)
+        {
+            subscription.periodMs = static_cast<uint16_t>(periodMs);
+            subscription.nextDueMs = millis(); // First sample goes out on the next serviceStreams()
+            return true;
+        }
     }
-    else
+    return false;
+}
+
+size_t CommunicationModuleMCU::sampleSensor(uint8_t sensor, uint8_t* data)
+{
+    switch (sensor)
     {
-        println("Unknown command");
+        case BIN_READ_ACCELERATION:
+        {
+            RawAccelerometer counts;
+            size_t length = 0;
+            if (latestAcceleration(counts, length) != I2C::OK)
+            {
+                return 0;
+            }
+            counts.writeRawData(data, length);
+            return length;
+        }
+
+        case BIN_READ_TEMPERATURE:
+        {
+            // Hundredths of a degree Celsius, signed 16-bit, MSB first
+            int16_t centiDegrees = readTemperature();
+            data[0] = static_cast<uint8_t>(static_cast<uint16_t>(centiDegrees) >> 8);
+            data[1] = static_cast<uint8_t>(centiDegrees & 0xFF);
+            return 2;
+        }
+
+        case BIN_READ_TOUCH:
+            data[0] = TSI_ReadSlider();
+            return 1;
+
+        default:
+            return 0;
     }
 }
 
-void CommunicationModuleMCU::onCharReceived(char c)
+uint8_t CommunicationModuleMCU::latestAcceleration(RawAccelerometer& counts, size_t& length)
 {
-    static size_t idx = 0;
+    length = 0;
+    MMA8451::Sample sample;
+    bool available = accelerometer.isCapturing() && accelerometer.latestSample(sample);
+    if (available && (millis() - sample.timestampMs) > ACCEL_STALE_MS)
+    {
+        available = false; // No interrupt for a while, e.g. the sensor was power cycled
+        accelerometer.stopCapture();
+    }
 
-    if (c == '\n')
+    if (!available && !accelerometer.isCapturing())
     {
-        buffer[idx] = '\0';
-        idx = 0;
-        dataReady = true;
+        uint8_t status = accelerometer.startCapture();
+        return (status == I2C::OK) ? I2C::PENDING : status;
+    }
+    if (!available)
+    {
+        return I2C::PENDING;
+    }
+
+    counts = sample.counts;
+    length = sample.length;
+    return I2C::OK;
+}
+
+uint8_t CommunicationModuleMCU::readAccelerationBatch(size_t& length)
+{
+    length = 0;
+    if (!accelerometer.isCapturing())
+    {
+        uint8_t status = accelerometer.startCapture();
+        if (status != I2C::OK)
+        {
+            return status;
+        }
+    }
+
+    // The ring holds at most RING_SIZE samples, so one drain always fits accelBatch
+    uint8_t count = 0;
+    uint8_t sampleSize = accelerometer.sampleSize();
+    MMA8451::Sample sample;
+    while (count < MMA8451::RING_SIZE && accelerometer.popSample(sample))
+    {
+        sample.counts.writeRawData(accelBatch + 1 + count * sampleSize, sampleSize);
+        ++count;
+    }
+
+    bool overflow = accelerometer.takeOverruns() > 0;
+    accelBatch[0] = static_cast<uint8_t>(count | (overflow ? BIN_BATCH_OVERFLOW : 0));
+    length = 1 + static_cast<size_t>(count) * sampleSize;
+    return I2C::OK;
+}
+
+bool CommunicationModuleMCU::setAccelerationRange(uint32_t rangeG, uint8_t& status)
+{
+    MMA8451::Range range;
+    switch (rangeG)
+    {
+        case 2:
+            range = MMA8451::Range::G2;
+            break;
+
+        case 4:
+            range = MMA8451::Range::G4;
+            break;
+
+        case 8:
+            range = MMA8451::Range::G8;
+            break;
+
+        default:
+            return false;
+    }
+
+    status = accelerometer.configure(range, accelerometer.getDataRate(), accelerometer.getOversampling());
+    return true;
+}
+
+template <typename Writer>
+void CommunicationModuleMCU::formatAcceleration(Writer& text, const uint8_t* xyz, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (i > 0)
+        {
+            text.character(' ');
+        }
+        text.decimal(xyz[i]);
+    }
+}
+
+template <typename Writer>
+void CommunicationModuleMCU::formatTemperature(Writer& text, int16_t centiDegrees)
+{
+    text.fixed(centiDegrees, 2).character('C'); // -3.25 C must not come out as "-3.-25C"
+}
+
+void CommunicationModuleMCU::printI2CError(uint8_t status)
+{
+    char line[36];
+    TextWriter(line, sizeof(line)).text("I2C error: ").text(I2C::statusText(status));
+    println(line);
+}
+
+void CommunicationModuleMCU::serviceStreams()
+{
+    for (Subscription& subscription : subscriptions)
+    {
+        if (subscription.periodMs == 0)
+        {
+            continue;
+        }
+
+        uint32_t now = millis();
+        if (static_cast<int32_t>(now - subscription.nextDueMs) < 0)
+        {
+            continue; // Not due yet (the signed difference survives the millis() wrap)
+        }
+        if (Uart::txFree() < STREAM_TX_RESERVE)
+        {
+            return; // Transmit ring still busy: keep the sample due instead of waiting for the UART
+        }
+
+        sendStreamSample(subscription, now);
+
+        // Advance by whole periods so the cadence does not drift with the transmit time;
+        // if the link cannot keep up, skip the missed slots instead of sending a burst
+        subscription.nextDueMs += subscription.periodMs;
+        if (static_cast<int32_t>(now - subscription.nextDueMs) >= 0)
+        {
+            subscription.nextDueMs = now + subscription.periodMs;
+        }
+    }
+}
+
+void CommunicationModuleMCU::sendStreamSample(const Subscription& subscription, uint32_t timestampMs)
+{
+    uint8_t data[6];
+    size_t length = sampleSensor(subscription.sensor, data);
+    if (length == 0)
+    {
+        return; // Sensor did not answer: skip this slot rather than stream a bogus value
+    }
+
+    if (binaryMode)
+    {
+        uint8_t payload[6 + sizeof(data)];
+        payload[0] = BIN_STREAM_SAMPLE;
+        payload[1] = subscription.sensor;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            payload[2 + i] = static_cast<uint8_t>(timestampMs >> (24 - 8 * i)); // MSB first
+        }
+        for (size_t i = 0; i < length; ++i)
+        {
+            payload[6 + i] = data[i];
+        }
+        sendBinaryFrame(payload, 6 + length);
+        return;
+    }
+
+    // Formatted straight into the transmit ring: no line buffer and no copy by println()
+    BasicTextWriter<Uart::TxSink> text;
+    text.character(STREAM_MARKER).text(subscription.name).character(' ').decimal(timestampMs).character(' ');
+
+    switch (subscription.sensor)
+    {
+        case BIN_READ_ACCELERATION:
+            formatAcceleration(text, data, length);
+            break;
+
+        case BIN_READ_TEMPERATURE:
+            formatTemperature(text, static_cast<int16_t>((data[0] << 8) | data[1]));
+            break;
+
+        default:
+            text.decimal(data[0]);
+            break;
+    }
+    text.text("\n\r");
+    text.sink().commit(); // Fits: serviceStreams() checked STREAM_TX_RESERVE first
+}
+
+void CommunicationModuleMCU::sendBinaryFrame(const uint8_t* payload, size_t length)
+{
+    static constexpr size_t MAX_PAYLOAD = 3 + ACCEL_BATCH_SIZE;
+    static uint8_t frame[BinaryProtocol::maxFrameSize(MAX_PAYLOAD)]; // Static: too large for the 1 KB stack
+
+    size_t frameLength = BinaryProtocol::encodeFrame(payload, (length < MAX_PAYLOAD) ? length : MAX_PAYLOAD, frame);
+    Uart::print(reinterpret_cast<const char*>(frame), frameLength);
+}
+
+void CommunicationModuleMCU::sendBinaryResponse(uint8_t command, uint8_t sequence, uint8_t status,
+                                                const uint8_t* data, size_t length)
+{
+    static constexpr size_t MAX_DATA = ACCEL_BATCH_SIZE;
+    static uint8_t payload[3 + MAX_DATA]; // Static: too large for the 1 KB stack
+
+    if (length > MAX_DATA)
+    {
+        length = MAX_DATA;
+    }
+
+    payload[0] = static_cast<uint8_t>(command | BIN_RESPONSE_FLAG);
+    payload[1] = sequence;
+    payload[2] = status;
+    for (size_t i = 0; i < length; ++i)
+    {
+        payload[3 + i] = data[i];
+    }
+
+    sendBinaryFrame(payload, 3 + length);
+}
+
+void CommunicationModuleMCU::handleBinaryFrame(const char* frame)
+{
+    uint8_t request[BUFFER_SIZE];
+    size_t length = BinaryProtocol::decodeFrame(reinterpret_cast<const uint8_t*>(frame), std::strlen(frame),
+                                                request, sizeof(request));
+    if (length < 2)
+    {
+        sendBinaryResponse(BIN_ERROR, 0, BIN_STATUS_BAD_FRAME);
+        return;
+    }
+
+    const uint8_t command = request[0];
+    const uint8_t sequence = request[1];
+
+    switch (command)
+    {
+        case BIN_PING:
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        case BIN_RESET:
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            Uart::flush();
+            NVIC_SystemReset();
+            break;
+
+        case BIN_GET_SYSTEM_INFO:
+        {
+            uint32_t uid[2] = { SIM->UIDML, SIM->UIDL };
+            uint8_t data[8];
+            for (size_t i = 0; i < 8; ++i)
+            {
+                data[i] = static_cast<uint8_t>(uid[i / 4] >> (24 - 8 * (i % 4))); // MSB first
+            }
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK, data, sizeof(data));
+            break;
+        }
+
+        case BIN_READ_TEMPERATURE:
+        case BIN_READ_TOUCH:
+        {
+            uint8_t data[6];
+            size_t dataLength = sampleSensor(command, data);
+            sendBinaryResponse(command, sequence, (dataLength > 0) ? BIN_STATUS_OK : BIN_STATUS_SENSOR_ERROR,
+                               data, dataLength);
+            break;
+        }
+
+        case BIN_READ_ACCELERATION:
+        {
+            uint8_t data[6];
+            RawAccelerometer counts;
+            size_t dataLength = 0;
+            uint8_t status = latestAcceleration(counts, dataLength);
+            if (status == I2C::OK)
+            {
+                counts.writeRawData(data, dataLength);
+            }
+            sendBinaryResponse(command, sequence,
+                               (status == I2C::OK) ? BIN_STATUS_OK
+                               : (status == I2C::PENDING) ? BIN_STATUS_NO_SAMPLE : BIN_STATUS_SENSOR_ERROR,
+                               data, dataLength);
+            break;
+        }
+
+        case BIN_READ_ACCEL_BATCH:
+        {
+            size_t batchLength = 0;
+            uint8_t status = readAccelerationBatch(batchLength);
+            sendBinaryResponse(command, sequence, (status == I2C::OK) ? BIN_STATUS_OK : BIN_STATUS_SENSOR_ERROR,
+                               accelBatch, batchLength);
+            break;
+        }
+
+        case BIN_SET_TOUCH:
+            self_calibration();
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        case BIN_SET_LED_COLOR_RED:
+            setLedColor(true, false, false);
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        case BIN_SET_LED_COLOR_GREEN:
+            setLedColor(false, true, false);
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        case BIN_SET_LED_COLOR_BLUE:
+            setLedColor(false, false, true);
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        case BIN_SET_ACCEL_RES:
+        {
+            uint8_t bits = (length >= 3) ? request[2] : 0;
+            if (bits != 8 && bits != 14)
+            {
+                sendBinaryResponse(command, sequence, BIN_STATUS_BAD_ARGUMENT);
+                break;
+            }
+            uint8_t status = accelerometer.setFastRead(bits == 8);
+            sendBinaryResponse(command, sequence, (status == I2C::OK) ? BIN_STATUS_OK : BIN_STATUS_SENSOR_ERROR);
+            break;
+        }
+
+        case BIN_SET_ACCEL_RANGE:
+        {
+            uint8_t status = I2C::OK;
+            if (length < 3 || !setAccelerationRange(request[2], status))
+            {
+                sendBinaryResponse(command, sequence, BIN_STATUS_BAD_ARGUMENT);
+                break;
+            }
+            uint8_t rangeG = accelerationRangeG();
+            sendBinaryResponse(command, sequence, (status == I2C::OK) ? BIN_STATUS_OK : BIN_STATUS_SENSOR_ERROR,
+                               &rangeG, 1);
+            break;
+        }
+
+        case BIN_READ_ACCEL_RANGE:
+        {
+            uint8_t rangeG = accelerationRangeG();
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK, &rangeG, 1);
+            break;
+        }
+
+        case BIN_SUBSCRIBE:
+        {
+            uint32_t periodMs = (length >= 5) ? ((static_cast<uint32_t>(request[3]) << 8) | request[4]) : 0;
+            bool accepted = (periodMs > 0) && setSubscription(request[2], periodMs);
+            sendBinaryResponse(command, sequence, accepted ? BIN_STATUS_OK : BIN_STATUS_BAD_ARGUMENT);
+            break;
+        }
+
+        case BIN_UNSUBSCRIBE:
+        {
+            bool accepted = true;
+            if (length >= 3 && request[2] != 0)
+            {
+                accepted = setSubscription(request[2], 0);
+            }
+            else
+            {
+                for (Subscription& subscription : subscriptions)
+                {
+                    subscription.periodMs = 0; // No sensor ID stops every stream
+                }
+            }
+            sendBinaryResponse(command, sequence, accepted ? BIN_STATUS_OK : BIN_STATUS_BAD_ARGUMENT);
+            break;
+        }
+
+        case BIN_SET_TEXT_MODE:
+            binaryMode = false; // Switch before answering, the next command is a text line again
+            sendBinaryResponse(command, sequence, BIN_STATUS_OK);
+            break;
+
+        default:
+            sendBinaryResponse(command, sequence, BIN_STATUS_UNKNOWN);
+            break;
+    }
+}
+
+void CommunicationModuleMCU::onCharReceived(char c)
+{
+    bool lineEnd;
+    if (binaryMode)
+    {
+        // Binary frames end at the COBS delimiter; '\r' and '\n' are ordinary data bytes
+        lineEnd = (c == static_cast<char>(BinaryProtocol::FRAME_DELIMITER));
     }
     else if (c == '\r')
     {
-        // Ignore carriage return
+        return; // Ignore carriage return
     }
     else
     {
-        if (idx < (BUFFER_SIZE - 1))
+        lineEnd = (c == '\n');
+    }
+
+    if (static_cast<uint8_t>(rxHead - rxTail) >= RX_SLOTS)
+    {
+        rxDiscarding = true; // Every slot holds an unhandled line: drop this one entirely
+    }
+
+    if (lineEnd)
+    {
+        if (!rxDiscarding)
         {
-            buffer[idx++] = c;
+            rxSlots[rxHead & (RX_SLOTS - 1)][rxLength] = '\0';
+            rxHead = static_cast<uint8_t>(rxHead + 1); // Publish the complete line
         }
+        rxLength = 0;
+        rxDiscarding = false;
+    }
+    else if (!rxDiscarding && rxLength < (BUFFER_SIZE - 1))
+    {
+        rxSlots[rxHead & (RX_SLOTS - 1)][rxLength++] = c;
     }
 }
 
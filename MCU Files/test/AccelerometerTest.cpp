@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file AccelerometerTest.cpp
+ * @brief Builds BasicAccelerometer.hpp with the integer instantiations the firmware uses.
+ *
+ * Compiled like the firmware, without exceptions and RTTI. Most checks are static_asserts on
+ * the constexpr parsing and conversions; the same calls are repeated at run time on bytes the
+ * compiler cannot see, as the firmware would make them on received data.
+ */
+
+#include "BasicAccelerometer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using mb::AccelerometerQ15;
+using mb::AccelerometerQ31;
+using mb::RawAccelerometer;
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool passed, const char* condition, int line)
+{
+    if (!passed)
+    {
+        std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, line, condition);
+        ++failures;
+    }
+}
+
+// 14-bit X/Y/Z, left-justified and MSB first: +1 g, -1 g and an odd count at +-2 g
+constexpr uint8_t SAMPLE[6] = { 0x40, 0x00, 0xC0, 0x00, 0x10, 0x04 };
+
+constexpr RawAccelerometer parseRaw()
+{
+    RawAccelerometer sample;
+    sample.parseRawData(SAMPLE, sizeof(SAMPLE));
+    return sample;
+}
+
+constexpr bool writesBack(size_t length)
+{
+    uint8_t bytes[6] = {};
+    if (!parseRaw().writeRawData(bytes, length))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        // The 3-byte layout holds only the MSBs, SAMPLE[0], SAMPLE[2] and SAMPLE[4]
+        if (bytes[i] != SAMPLE[(length == 3) ? 2 * i : i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr AccelerometerQ15 parseQ15(unsigned int rangeG)
+{
+    AccelerometerQ15 sample;
+    sample.parseRawData(SAMPLE, sizeof(SAMPLE), AccelerometerQ15::scaleForRange(rangeG));
+    return sample;
+}
+
+static_assert(parseRaw() == RawAccelerometer(0x4000, -0x4000, 0x1004), "Counts are kept as read");
+static_assert(writesBack(6) && writesBack(3), "writeRawData() restores the bytes that were parsed");
+static_assert(parseQ15(2).getX() == 0x1000 && parseQ15(8).getX() == 0x4000, "Q15 does not depend on the range");
+static_assert(parseQ15(2).getZ() * 4 == 0x1004, "14-bit samples convert to Q15 exactly");
+static_assert(parseRaw().convert<mb::Q15>(2) == parseQ15(2), "Parsing to Q15 equals converting the counts");
+static_assert(parseRaw().convert<mb::Q31>(4).getX() == (int32_t(1) << 29), "2 g is a quarter of the Q31 range");
+static_assert(parseQ15(4).convert<int16_t>(4) == parseRaw(), "Q15 -> Q31 -> int16 round-trip at +-4 g");
+static_assert(AccelerometerQ15(30000, 0, 0) + AccelerometerQ15(30000, 0, 0) == AccelerometerQ15(32767, 0, 0),
+              "Sums saturate");
+static_assert(AccelerometerQ15(-30000, 0, 0) - AccelerometerQ15(30000, 0, 0) == AccelerometerQ15(-32768, 0, 0),
+              "Differences saturate");
+static_assert(RawAccelerometer(-32768, -32768, -32768).squaredMagnitude() == 3u << 30,
+              "The squared magnitude of counts fits in 32 bits");
+static_assert(AccelerometerQ31(INT32_MIN, INT32_MIN, INT32_MIN).squaredMagnitude() == 3ull << 62,
+              "The squared magnitude of Q31 fits in 64 bits");
+static_assert(AccelerometerQ15(3, 4, 0) <= AccelerometerQ15(0, 0, 5) && !(AccelerometerQ15(3, 4, 1) <= AccelerometerQ15(0, 0, 5)),
+              "Integer ordering is exact");
+
+int main()
+{
+    // Through a volatile copy, so the calls below are compiled rather than folded
+    volatile uint8_t received[6];
+    for (size_t i = 0; i < sizeof(SAMPLE); ++i)
+    {
+        received[i] = SAMPLE[i];
+    }
+    uint8_t bytes[6];
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+    {
+        bytes[i] = received[i];
+    }
+
+    RawAccelerometer raw;
+    CHECK(raw.parseRawData(bytes, sizeof(bytes)));
+    CHECK(raw == parseRaw());
+    CHECK(!raw.parseRawData(bytes, 4));
+    uint8_t written[6] = {};
+    CHECK(raw.writeRawData(written, sizeof(written)) && std::memcmp(written, bytes, sizeof(bytes)) == 0);
+    CHECK(!raw.writeRawData(written, 4));
+
+    AccelerometerQ15 q15;
+    CHECK(q15.parseRawData(bytes, 3, AccelerometerQ15::scaleForRange(2))); // 8-bit fast read
+    CHECK(q15 == AccelerometerQ15(0x1000, 0, -0x1000)); // MSBs 0x40, 0x00, 0xC0
+    CHECK(q15.convert<mb::Q31>().convert<mb::Q15>() == q15);
+    CHECK(raw.convert<mb::Q15>(2).convert<mb::Q31>().convert<int16_t>(2) == raw);
+
+    if (failures != 0)
+    {
+        std::printf("AccelerometerTest: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("AccelerometerTest passed\n");
+    return 0;
+}
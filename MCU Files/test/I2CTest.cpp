@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file I2CTest.cpp
+ * @brief Host test of the queued, interrupt-driven I2C master (namespace I2C in BoardSupport.cpp).
+ *
+ * Every access to I2C0->C1, S and D goes to a bus model with one device at 0x1D that has a
+ * 256-byte register file. The model logs what would appear on the bus (S, Sr, P, bytes sent,
+ * r/rN for bytes received with ACK/NACK, N for a NACK from the device) and raises the
+ * interrupt after each byte; the test then calls I2C0_IRQHandler() like the NVIC would.
+ * SysTick_Handler() is called to advance millis() for the timeout.
+ */
+
+#include "BoardSupport.hpp"
+
+#include <cstdio>
+#include <string>
+
+static SIM_Type simRegisters {};
+static PORT_Type portARegisters {};
+static PORT_Type portBRegisters {};
+static GPIO_Type gpioARegisters {};
+static GPIO_Type gpioBRegisters {};
+static UART0_Type uartRegisters {};
+static I2C_Type i2cRegisters {};
+static ADC_Type adcRegisters {};
+static TSI_Type tsiRegisters {};
+static SysTick_Type sysTickRegisters {};
+
+SIM_Type* SIM = &simRegisters;
+PORT_Type* PORTA = &portARegisters;
+PORT_Type* PORTB = &portBRegisters;
+GPIO_Type* PTA = &gpioARegisters;
+GPIO_Type* PTB = &gpioBRegisters;
+UART0_Type* UART0 = &uartRegisters;
+I2C_Type* I2C0 = &i2cRegisters;
+ADC_Type* ADC0 = &adcRegisters;
+TSI_Type* TSI0 = &tsiRegisters;
+SysTick_Type* SysTick = &sysTickRegisters;
+uint32_t SystemCoreClock = 48000000u;
+volatile uint32_t hostPrimask = 0;
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+extern "C" void I2C0_IRQHandler(void);
+extern "C" void SysTick_Handler(void);
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool passed, const char* condition, int line)
+{
+    if (!passed)
+    {
+        std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, line, condition);
+        ++failures;
+    }
+}
+
+/**
+ * @struct Bus
+ * @brief State of the modelled bus and of its only device.
+ */
+struct Bus
+{
+    static constexpr uint8_t DEVICE_ADDRESS = 0x1D;
+
+    uint8_t registers[256] {};
+    uint8_t pointer = 0;           // Device register pointer, auto-incremented
+    uint8_t received = 0;          // Byte the controller holds in D for the next read
+    bool addressNext = false;      // The next byte written follows a START
+    bool addressed = false;        // The device acknowledged its address
+    bool registerNext = false;     // The next byte written is the register pointer
+    bool silent = false;           // The device holds SCL: no byte completes, no interrupt
+    int nackFromByte = -1;         // Index of the first byte the device refuses, -1 for none
+    int bytesWritten = 0;
+    bool interruptPending = false;
+    std::string log;
+};
+
+static Bus bus;
+
+/**
+ * @brief A byte has been shifted: sets IICIF, BUSY and the acknowledge bit, and requests the interrupt.
+ */
+static void byteDone(bool nack)
+{
+    if (bus.silent)
+    {
+        return;
+    }
+    I2C0->S.value = I2C_S_IICIF_MASK | I2C_S_BUSY_MASK | (nack ? I2C_S_RXAK_MASK : 0);
+    bus.interruptPending = true;
+}
+
+uint8_t hostI2CRead(HostI2CRegister& reg)
+{
+    if (&reg != &I2C0->D)
+    {
+        return reg.value;
+    }
+
+    // Reading D returns the byte held; in master receive mode it also clocks in the next one
+    const uint8_t held = bus.received;
+    const uint8_t control = I2C0->C1.value;
+    if (!(control & I2C_C1_MST_MASK) || (control & I2C_C1_TX_MASK))
+    {
+        return held;
+    }
+    const bool acknowledged = !(control & I2C_C1_TXAK_MASK);
+    bus.received = bus.registers[bus.pointer++];
+    bus.log += acknowledged ? "r " : "rN ";
+    byteDone(false);
+    return held;
+}
+
+void hostI2CWrite(HostI2CRegister& reg, uint8_t written)
+{
+    if (&reg == &I2C0->S)
+    {
+        reg.value &= static_cast<uint8_t>(~(written & (I2C_S_IICIF_MASK | I2C_S_ARBL_MASK))); // Write-1-to-clear
+        return;
+    }
+
+    if (&reg == &I2C0->C1)
+    {
+        const uint8_t before = reg.value;
+        reg.value = written;
+        if (!(before & I2C_C1_MST_MASK) && (written & I2C_C1_MST_MASK))
+        {
+            bus.log += "S ";
+            bus.addressNext = true;
+        }
+        if (written & I2C_C1_RSTA_MASK)
+        {
+            bus.log += "Sr ";
+            bus.addressNext = true;
+            reg.value &= static_cast<uint8_t>(~I2C_C1_RSTA_MASK); // RSTA always reads as zero
+        }
+        if ((before & I2C_C1_MST_MASK) && !(written & I2C_C1_MST_MASK))
+        {
+            bus.log += "P ";
+            bus.addressed = false;
+            I2C0->S.value &= static_cast<uint8_t>(~I2C_S_BUSY_MASK);
+        }
+        return;
+    }
+
+    reg.value = written;
+    if (&reg != &I2C0->D)
+    {
+        return;
+    }
+    if (!(I2C0->C1.value & I2C_C1_MST_MASK) || !(I2C0->C1.value & I2C_C1_TX_MASK))
+    {
+        bus.log += "!D ";
+        return;
+    }
+
+    char text[4];
+    std::snprintf(text, sizeof(text), "%02X", written);
+    bus.log += text;
+    bus.log += ' ';
+
+    bool acknowledged = bus.addressed;
+    if (bus.addressNext)
+    {
+        bus.addressNext = false;
+        bus.addressed = ((written >> 1) == Bus::DEVICE_ADDRESS);
+        bus.registerNext = !(written & 1u);
+        acknowledged = bus.addressed;
+    }
+    else if (bus.registerNext)
+    {
+        bus.registerNext = false;
+        bus.pointer = written;
+    }
+    else
+    {
+        bus.registers[bus.pointer++] = written;
+    }
+
+    if ((bus.nackFromByte >= 0) && (bus.bytesWritten >= bus.nackFromByte))
+    {
+        acknowledged = false;
+    }
+    ++bus.bytesWritten;
+    if (!acknowledged)
+    {
+        bus.log += "N ";
+    }
+    byteDone(!acknowledged);
+}
+
+/**
+ * @brief Runs the I2C interrupt until the bus model stops requesting it.
+ */
+static void runInterrupts()
+{
+    for (int i = 0; (i < 1000) && bus.interruptPending; ++i)
+    {
+        bus.interruptPending = false;
+        I2C0_IRQHandler();
+    }
+}
+
+/**
+ * @brief Advances millis() by the given number of SysTick interrupts.
+ */
+static void tick(int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        SysTick_Handler();
+        runInterrupts();
+    }
+}
+
+static void resetBus()
+{
+    bus.log.clear();
+    bus.silent = false;
+    bus.nackFromByte = -1;
+    bus.bytesWritten = 0;
+}
+
+static void testRegisterWrite()
+{
+    resetBus();
+    uint8_t value = 0x01;
+    I2C::Transfer transfer { 0x1D, 0x2A, &value, 1, false };
+    CHECK(I2C::submit(transfer));
+    CHECK(transfer.status == I2C::PENDING);
+    runInterrupts();
+
+    CHECK(transfer.status == I2C::OK);
+    CHECK(bus.log == "S 3A 2A 01 P ");
+    CHECK(bus.registers[0x2A] == 0x01);
+}
+
+static void testRegisterRead()
+{
+    // ADDRESS_WRITE -> REGISTER -> ADDRESS_READ -> READ_DATA, the last byte NACKed before the STOP
+    resetBus();
+    uint8_t sample[6] = {};
+    I2C::Transfer transfer { 0x1D, 0x01, sample, 6, true };
+    I2C::submit(transfer);
+    runInterrupts();
+
+    CHECK(transfer.status == I2C::OK);
+    CHECK(bus.log == "S 3A 01 Sr 3B r r r r r rN P ");
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+        CHECK(sample[i] == bus.registers[0x01 + i]);
+    }
+
+    // A single byte is NACKed from the start
+    resetBus();
+    uint8_t whoAmI = 0;
+    I2C::Transfer single { 0x1D, 0x0D, &whoAmI, 1, true };
+    I2C::submit(single);
+    runInterrupts();
+
+    CHECK(single.status == I2C::OK);
+    CHECK(bus.log == "S 3A 0D Sr 3B rN P ");
+    CHECK(whoAmI == bus.registers[0x0D]);
+}
+
+static void testNack()
+{
+    // No device at 0x1C: the address byte is refused and the transfer ends with a STOP
+    resetBus();
+    uint8_t data[2] = {};
+    I2C::Transfer absent { 0x1C, 0x01, data, 2, true };
+    I2C::submit(absent);
+    runInterrupts();
+    CHECK(absent.status == I2C::ERROR_NACK);
+    CHECK(bus.log == "S 38 N P ");
+
+    // The device refuses the data byte of a write
+    resetBus();
+    bus.nackFromByte = 2;
+    uint8_t value = 0x55;
+    I2C::Transfer refused { 0x1D, 0x2B, &value, 1, false };
+    I2C::submit(refused);
+    runInterrupts();
+    CHECK(refused.status == I2C::ERROR_NACK);
+    CHECK(bus.log == "S 3A 2B 55 N P ");
+}
+
+static void testTimeoutStartsNextTransfer()
+{
+    resetBus();
+    uint8_t first = 0x05;
+    uint8_t second = 0x06;
+    uint8_t read[2] = {};
+    uint8_t spare = 0;
+    I2C::Transfer stalled { 0x1D, 0x10, &first, 1, false };
+    I2C::Transfer write { 0x1D, 0x11, &second, 1, false };
+    I2C::Transfer readBack { 0x1D, 0x10, read, 2, true };
+
+    // The device holds the bus, so the first transfer never gets past its address byte
+    bus.silent = true;
+    CHECK(I2C::submit(stalled));
+    CHECK(I2C::submit(write));
+    CHECK(I2C::submit(readBack));
+
+    I2C::Transfer filler[I2C::QUEUE_SIZE - 3];
+    for (auto& transfer : filler)
+    {
+        transfer = I2C::Transfer { 0x1D, 0x00, &spare, 1, true };
+        CHECK(I2C::submit(transfer));
+    }
+    I2C::Transfer overflow { 0x1D, 0x00, &spare, 1, true };
+    CHECK(!I2C::submit(overflow));
+    CHECK(overflow.status == I2C::ERROR_QUEUE_FULL);
+
+    // Still within TIMEOUT_MS of the START
+    tick(static_cast<int>(I2C::TIMEOUT_MS) - 1);
+    CHECK(stalled.status == I2C::PENDING);
+
+    // checkTimeout() releases the bus, finish() reports the timeout and startNext() runs the queue
+    bus.silent = false;
+    tick(1);
+    CHECK(stalled.status == I2C::ERROR_TIMEOUT);
+    CHECK(write.status == I2C::OK);
+    CHECK(readBack.status == I2C::OK);
+    CHECK(read[0] == 0xA0 + 0x10); // The aborted write never reached register 0x10
+    CHECK(read[1] == 0x06);
+    for (const auto& transfer : filler)
+    {
+        CHECK(transfer.status == I2C::OK);
+    }
+    CHECK(bus.log.compare(0, 12, "S 3A P S 3A ") == 0);
+    CHECK(!(I2C0->S.value & I2C_S_BUSY_MASK));
+
+    // A late interrupt of the aborted transfer finds the bus idle and is ignored
+    bus.interruptPending = true;
+    runInterrupts();
+    CHECK(I2C::submit(overflow));
+    runInterrupts();
+    CHECK(overflow.status == I2C::OK);
+}
+
+static void testCallbackSubmitsFollowUp()
+{
+    static uint8_t sample[6] = {};
+    static I2C::Transfer followUp { 0x1D, 0x01, sample, 6, true };
+    static int calls = 0;
+
+    resetBus();
+    uint8_t value = 0x01;
+    I2C::Transfer first { 0x1D, 0x2A, &value, 1, false, [](I2C::Transfer&) { ++calls; I2C::submit(followUp); } };
+    I2C::submit(first);
+    runInterrupts();
+
+    CHECK(calls == 1);
+    CHECK(first.status == I2C::OK);
+    CHECK(followUp.status == I2C::OK);
+    CHECK(bus.log == "S 3A 2A 01 P S 3A 01 Sr 3B r r r r r rN P ");
+}
+
+int main()
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        bus.registers[i] = static_cast<uint8_t>(0xA0 + i);
+    }
+    I2C::init();
+    CHECK(I2C0->C1.value == (I2C_C1_IICEN_MASK | I2C_C1_IICIE_MASK));
+
+    testRegisterWrite();
+    testRegisterRead();
+    testNack();
+    testTimeoutStartsNextTransfer();
+    testCallbackSubmitsFollowUp();
+
+    if (failures != 0)
+    {
+        std::printf("I2CTest: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("I2CTest passed\n");
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file UartTest.cpp
+ * @brief Host test of the interrupt-driven UART0 transmit ring (Uart.cpp).
+ *
+ * UART0 is a struct in RAM. The test plays the transmitter: it sets TDRE/TC in S1, calls
+ * UART0_IRQHandler() and collects the byte the handler wrote to D. Checked: bytes come out in
+ * order across the end of the ring, tryPrint() refuses text that does not fit, the interrupt
+ * hands over from TIE to TCIE once the ring is drained, queueing text leaves the caller's
+ * interrupt mask as it was, and a line formatted through Uart::TxSink is queued only as a whole.
+ */
+
+#include "Uart.hpp"
+#include "CommunicationModuleMCU.hpp"
+#include "TextWriter.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static SIM_Type simRegisters {};
+static PORT_Type portBRegisters {};
+static UART0_Type uartRegisters {};
+
+SIM_Type* SIM = &simRegisters;
+PORT_Type* PORTB = &portBRegisters;
+UART0_Type* UART0 = &uartRegisters;
+uint32_t SystemCoreClock = 48000000u;
+volatile uint32_t hostPrimask = 0;
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+// Uart.cpp forwards received characters here; this test only transmits
+void mb::CommunicationModuleMCU::onCharReceived(char)
+{
+}
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool passed, const char* condition, int line)
+{
+    if (!passed)
+    {
+        std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, line, condition);
+        ++failures;
+    }
+}
+
+static std::string wire; /**< Bytes the "transmitter" has accepted from D. */
+
+/**
+ * @brief One transmitter interrupt: the data register and the shifter are both empty.
+ * @return True if the handler wrote a byte to D.
+ */
+static bool transmitterInterrupt()
+{
+    size_t freeBefore = mb::Uart::txFree();
+    UART0->S1 = UART0_S1_TDRE_MASK | UART0_S1_TC_MASK;
+    UART0_IRQHandler();
+    if (mb::Uart::txFree() == freeBefore + 1)
+    {
+        wire += static_cast<char>(UART0->D);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs transmitter interrupts while TIE is enabled, i.e. until the ring is drained.
+ */
+static void drain()
+{
+    for (size_t i = 0; (i <= mb::Uart::TX_BUFFER_SIZE) && (UART0->C2 & UART0_C2_TIE_MASK); ++i)
+    {
+        transmitterInterrupt();
+    }
+}
+
+static std::string pattern(size_t length, char first)
+{
+    std::string text;
+    for (size_t i = 0; i < length; ++i)
+    {
+        text += static_cast<char>(first + i % 26);
+    }
+    return text;
+}
+
+static void testRingWraps()
+{
+    const size_t capacity = mb::Uart::TX_BUFFER_SIZE - 1;
+    CHECK(mb::Uart::txFree() == capacity);
+
+    // Two passes of 200 bytes: the second one crosses the end of the 256-byte ring
+    for (char first : {'a', 'A'})
+    {
+        wire.clear();
+        std::string text = pattern(200, first);
+        mb::Uart::print(text.c_str());
+        CHECK(wire.empty()); // print() only queues
+        CHECK(mb::Uart::txFree() == capacity - 200);
+        CHECK(UART0->C2 & UART0_C2_TIE_MASK);
+
+        drain();
+        CHECK(wire == text);
+        CHECK(mb::Uart::txFree() == capacity);
+    }
+}
+
+static void testTryPrintRefusesWhenFull()
+{
+    const size_t capacity = mb::Uart::TX_BUFFER_SIZE - 1;
+    std::string filler = pattern(capacity - 5, 'a');
+    CHECK(mb::Uart::tryPrint(filler.data(), filler.size()));
+    CHECK(mb::Uart::txFree() == 5);
+
+    // All or nothing: 6 bytes do not fit, so none of them are queued
+    CHECK(!mb::Uart::tryPrint("123456", 6));
+    CHECK(mb::Uart::txFree() == 5);
+    CHECK(mb::Uart::tryPrint("12345", 5));
+    CHECK(mb::Uart::txFree() == 0);
+
+    wire.clear();
+    drain();
+    CHECK(wire == filler + "12345");
+}
+
+static void testInterruptHandsOverToTransmitComplete()
+{
+    wire.clear();
+    mb::Uart::println("ok");
+
+    // Two characters plus "\n\r", one per TDRE interrupt
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(transmitterInterrupt());
+    }
+    CHECK(UART0->C2 & UART0_C2_TIE_MASK);
+
+    // Ring empty: the next TDRE interrupt switches to waiting for transmit complete
+    CHECK(!transmitterInterrupt());
+    CHECK(!(UART0->C2 & UART0_C2_TIE_MASK));
+    CHECK(UART0->C2 & UART0_C2_TCIE_MASK);
+    CHECK(wire == "ok\n\r");
+
+    // TC: the last stop bit has left, so TCIE is turned off and flush() no longer waits
+    UART0->S1 = UART0_S1_TC_MASK;
+    UART0_IRQHandler();
+    CHECK(!(UART0->C2 & (UART0_C2_TIE_MASK | UART0_C2_TCIE_MASK)));
+    if (failures == 0)
+    {
+        mb::Uart::flush(); // Would spin forever if the handover above went wrong
+    }
+}
+
+static void testPrintKeepsInterruptsMasked()
+{
+    // Printing from a critical section must not unmask interrupts behind the caller's back
+    wire.clear();
+    __disable_irq();
+    mb::Uart::print("x");
+    CHECK(__get_PRIMASK() == 1);
+    __enable_irq();
+
+    mb::Uart::print("y");
+    CHECK(__get_PRIMASK() == 0);
+    drain();
+    CHECK(wire == "xy");
+}
+
+static void testTxSinkQueuesWholeLines()
+{
+    wire.clear();
+    const size_t capacity = mb::Uart::TX_BUFFER_SIZE - 1;
+    char expected[48];
+    mb::TextWriter(expected, sizeof(expected)).character('!').text("readaccel ").decimal(4294967295u)
+        .character(' ').fixed(-325, 2).character(' ').hex(0xBEEF, 4).text("\n\r");
+
+    mb::BasicTextWriter<mb::Uart::TxSink> line;
+    line.character('!').text("readaccel ").decimal(4294967295u).character(' ').fixed(-325, 2).character(' ')
+        .hex(0xBEEF, 4).text("\n\r");
+    CHECK(mb::Uart::txFree() == capacity); // Stored but not queued yet
+    CHECK(line.sink().commit());
+    CHECK(mb::Uart::txFree() == capacity - std::strlen(expected));
+    drain();
+    CHECK(wire == expected);
+
+    // A line that does not fit is dropped as a whole, without waiting for the transmitter
+    std::string filler = pattern(capacity - 4, 'a');
+    CHECK(mb::Uart::tryPrint(filler.data(), filler.size()));
+    mb::BasicTextWriter<mb::Uart::TxSink> tooLong;
+    tooLong.text("12345");
+    CHECK(!tooLong.sink().commit());
+    CHECK(mb::Uart::txFree() == 4);
+
+    wire.clear();
+    drain();
+    CHECK(wire == filler);
+}
+
+int main()
+{
+    mb::Uart uart(9600, nullptr);
+    CHECK(UART0->C2 & UART0_C2_RIE_MASK);
+
+    testRingWraps();
+    testTryPrintRefusesWhenFull();
+    testInterruptHandsOverToTransmitComplete();
+    testPrintKeepsInterruptsMasked();
+    testTxSinkQueuesWholeLines();
+
+    if (failures != 0)
+    {
+        std::printf("UartTest: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("UartTest passed\n");
+    return 0;
+}
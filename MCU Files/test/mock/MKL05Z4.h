@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file MKL05Z4.h
+ * @brief Host stand-in for the KL05Z device header, used by the host tests only.
+ *
+ * Peripherals are plain structs in RAM; each test defines the peripheral pointers and may
+ * set status registers before calling an interrupt handler. The I2C registers are the
+ * exception: every access goes through hostI2CRead()/hostI2CWrite(), which the I2C test
+ * implements as a bus model. Interrupt masking only records PRIMASK, the tests run single-threaded.
+ */
+
+#ifndef MKL05Z4_HOST_MOCK_H
+#define MKL05Z4_HOST_MOCK_H
+
+#include <stdint.h>
+
+#define __IO volatile
+#define __I  volatile const
+#define __O  volatile
+
+typedef enum
+{
+    DMA0_IRQn  = 0,
+    I2C0_IRQn  = 8,
+    UART0_IRQn = 12,
+    ADC0_IRQn  = 15,
+    TSI0_IRQn  = 26,
+    PORTA_IRQn = 30,
+    PORTB_IRQn = 31
+} IRQn_Type;
+
+/* ----- Register layouts (only the registers the firmware touches) ----- */
+
+typedef struct
+{
+    __IO uint32_t SOPT1, SOPT1CFG;
+    uint32_t RESERVED0[1023];
+    __IO uint32_t SOPT2, RESERVED1, SOPT4, SOPT5, RESERVED2, SOPT7, RESERVED3[2], SDID, RESERVED4[3];
+    __IO uint32_t SCGC4, SCGC5, SCGC6, SCGC7, CLKDIV1, RESERVED5, FCFG1, FCFG2, RESERVED6;
+    __I  uint32_t UIDMH, UIDML, UIDL;
+    uint32_t RESERVED7[39];
+    __IO uint32_t COPC, SRVCOP;
+} SIM_Type;
+
+typedef struct
+{
+    __IO uint32_t PCR[32];
+    __O  uint32_t GPCLR, GPCHR;
+    uint32_t RESERVED0[6];
+    __IO uint32_t ISFR;
+} PORT_Type;
+
+typedef struct
+{
+    __IO uint32_t PDOR;
+    __O  uint32_t PSOR, PCOR, PTOR;
+    __I  uint32_t PDIR;
+    __IO uint32_t PDDR;
+} GPIO_Type;
+
+typedef struct
+{
+    __IO uint8_t BDH, BDL, C1, C2, S1, S2, C3, D, MA1, MA2, C4, C5;
+} UART0_Type;
+
+#ifdef __cplusplus
+/**
+ * @brief I2C register whose reads and writes are forwarded to the test's bus model.
+ */
+struct HostI2CRegister
+{
+    uint8_t value;
+
+    operator uint8_t();
+    HostI2CRegister& operator=(uint32_t written);
+    HostI2CRegister& operator|=(uint32_t bits) { return *this = value | bits; }
+    HostI2CRegister& operator&=(uint32_t bits) { return *this = value & bits; }
+};
+
+uint8_t hostI2CRead(HostI2CRegister& reg);                /**< Implemented by the test that uses I2C0. */
+void hostI2CWrite(HostI2CRegister& reg, uint8_t written); /**< Implemented by the test that uses I2C0. */
+
+inline HostI2CRegister::operator uint8_t()
+{
+    return hostI2CRead(*this);
+}
+
+inline HostI2CRegister& HostI2CRegister::operator=(uint32_t written)
+{
+    hostI2CWrite(*this, static_cast<uint8_t>(written));
+    return *this;
+}
+
+typedef struct
+{
+    HostI2CRegister A1, F, C1, S, D;
+} I2C_Type;
+#endif
+
+typedef struct
+{
+    __IO uint32_t SC1[2], CFG1, CFG2;
+    __I  uint32_t R[2];
+    __IO uint32_t CV1, CV2, SC2, SC3, OFS, PG, MG, CLPD, CLPS, CLP4, CLP3, CLP2, CLP1, CLP0, RESERVED0;
+    __IO uint32_t CLMD, CLMS, CLM4, CLM3, CLM2, CLM1, CLM0;
+} ADC_Type;
+
+typedef struct
+{
+    __IO uint32_t GENCS, DATA, TSHD;
+} TSI_Type;
+
+typedef struct
+{
+    __IO uint32_t CTRL, LOAD, VAL;
+    __I  uint32_t CALIB;
+} SysTick_Type;
+
+/* ----- Peripheral instances, defined by each test ----- */
+
+extern SIM_Type* SIM;
+extern PORT_Type* PORTA;
+extern PORT_Type* PORTB;
+extern GPIO_Type* PTA;
+extern GPIO_Type* PTB;
+extern UART0_Type* UART0;
+#ifdef __cplusplus
+extern I2C_Type* I2C0;
+#endif
+extern ADC_Type* ADC0;
+extern TSI_Type* TSI0;
+extern SysTick_Type* SysTick;
+
+extern uint32_t SystemCoreClock;
+void SystemCoreClockUpdate(void);
+
+/* ----- Core functions ----- */
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) { (void)irq; (void)priority; }
+static inline void NVIC_SystemReset(void) {}
+static inline uint32_t SysTick_Config(uint32_t ticks) { (void)ticks; return 0; }
+
+extern volatile uint32_t hostPrimask; /**< Interrupt mask state, defined by each test; nothing is masked. */
+
+static inline void __disable_irq(void) { hostPrimask = 1; }
+static inline void __enable_irq(void) { hostPrimask = 0; }
+static inline uint32_t __get_PRIMASK(void) { return hostPrimask; }
+static inline void __set_PRIMASK(uint32_t primask) { hostPrimask = primask; }
+static inline void __WFI(void) {}
+static inline void __DSB(void) {}
+static inline void __NOP(void) {}
+
+/* ----- Bit fields ----- */
+
+#define SIM_SCGC4_I2C0_MASK     (1u << 6)
+#define SIM_SCGC4_UART0_MASK    (1u << 10)
+#define SIM_SCGC5_TSI_MASK      (1u << 5)
+#define SIM_SCGC5_PORTA_MASK    (1u << 9)
+#define SIM_SCGC5_PORTB_MASK    (1u << 10)
+#define SIM_SCGC6_ADC0_MASK     (1u << 27)
+
+#define PORT_PCR_PS_MASK        0x1u
+#define PORT_PCR_PE_MASK        0x2u
+#define PORT_PCR_MUX_MASK       (7u << 8)
+#define PORT_PCR_MUX(x)         (((uint32_t)(x) << 8) & PORT_PCR_MUX_MASK)
+#define PORT_PCR_IRQC_MASK      (0xFu << 16)
+#define PORT_PCR_IRQC(x)        (((uint32_t)(x) << 16) & PORT_PCR_IRQC_MASK)
+#define PORT_PCR_ISF_MASK       (1u << 24)
+
+#define UART0_C2_RE_MASK        0x04u
+#define UART0_C2_TE_MASK        0x08u
+#define UART0_C2_RIE_MASK       0x20u
+#define UART0_C2_TCIE_MASK      0x40u
+#define UART0_C2_TIE_MASK       0x80u
+#define UART0_S1_OR_MASK        0x08u
+#define UART0_S1_RDRF_MASK      0x20u
+#define UART0_S1_TC_MASK        0x40u
+#define UART0_S1_TDRE_MASK      0x80u
+
+#define I2C_C1_RSTA_MASK        0x04u
+#define I2C_C1_TXAK_MASK        0x08u
+#define I2C_C1_TX_MASK          0x10u
+#define I2C_C1_MST_MASK         0x20u
+#define I2C_C1_IICIE_MASK       0x40u
+#define I2C_C1_IICEN_MASK       0x80u
+#define I2C_S_RXAK_MASK         0x01u
+#define I2C_S_IICIF_MASK        0x02u
+#define I2C_S_ARBL_MASK         0x10u
+#define I2C_S_BUSY_MASK         0x20u
+#define I2C_S_TCF_MASK          0x80u
+
+#define ADC_CFG1_ADICLK(x)      ((uint32_t)(x) & 0x3u)
+#define ADC_CFG1_MODE(x)        (((uint32_t)(x) & 0x3u) << 2)
+#define ADC_CFG1_ADLSMP_MASK    0x10u
+#define ADC_CFG1_ADIV(x)        (((uint32_t)(x) & 0x3u) << 5)
+#define ADC_CFG2_ADHSC_MASK     0x04u
+#define ADC_SC1_ADCH_MASK       0x1Fu
+#define ADC_SC1_ADCH(x)         ((uint32_t)(x) & ADC_SC1_ADCH_MASK)
+#define ADC_SC1_AIEN_MASK       0x40u
+#define ADC_SC1_COCO_MASK       0x80u
+#define ADC_SC2_DMAEN_MASK      0x04u
+#define ADC_SC3_AVGS_MASK       0x03u
+#define ADC_SC3_AVGS(x)         ((uint32_t)(x) & ADC_SC3_AVGS_MASK)
+#define ADC_SC3_AVGE_MASK       0x04u
+#define ADC_SC3_ADCO_MASK       0x08u
+#define ADC_SC3_CALF_MASK       0x40u
+#define ADC_SC3_CAL_MASK        0x80u
+
+#define TSI_GENCS_EOSF_MASK     (1u << 2)
+#define TSI_GENCS_TSIIEN_MASK   (1u << 6)
+#define TSI_GENCS_TSIEN_MASK    (1u << 7)
+
+#define SysTick_CTRL_ENABLE_Msk 1u
+
+#endif /* MKL05Z4_HOST_MOCK_H */
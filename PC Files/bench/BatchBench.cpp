@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file BatchBench.cpp
+ * @brief Compares AccelerometerBatch::append() with converting samples one by one.
+ *
+ * Random 14-bit samples are converted to g by the batch (structure of arrays, SIMD), by a loop
+ * of Accelerometer::parseRawData() that stores into three axis arrays (the scalar way to fill
+ * the same layout) and by the same loop into a vector of objects, once with a working set that
+ * fits in cache and once with a large one. All paths must produce the same values.
+ *
+ * Usage: BatchBench [samples in cache] [samples out of cache]   (default 4096 and 4194304)
+ */
+
+#include "AccelerometerBatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Returns the best time per sample of repeated runs, in nanoseconds.
+     */
+    template <typename Body>
+    double bestNsPerSample(size_t samples, int repetitions, Body &&body) {
+        double best = 1e30;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            const auto start = Clock::now();
+            body();
+            const auto stop = Clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / static_cast<double>(samples);
+    }
+
+    /**
+     * @brief Converts the same samples with both paths and prints the times.
+     * @return False if the paths disagree on any value.
+     */
+    bool run(size_t samples, int repetitions) {
+        std::mt19937 rng(7);
+        std::vector<uint8_t> raw(samples * 6);
+        for (auto &byte : raw) {
+            byte = static_cast<uint8_t>(rng());
+        }
+
+        const float scale = mb::Accelerometer::scaleForRange(2);
+        mb::AccelerometerBatch batch(samples);
+        std::vector<mb::Accelerometer> objects(samples);
+        std::vector<float> x(samples), y(samples), z(samples);
+
+        const double batchNs = bestNsPerSample(samples, repetitions, [&] {
+            batch.clear();
+            batch.append(raw.data(), samples, 6, scale);
+        });
+        const double arraysNs = bestNsPerSample(samples, repetitions, [&] {
+            mb::Accelerometer sample;
+            for (size_t i = 0; i < samples; ++i) {
+                sample.parseRawData(raw.data() + i * 6, 6, scale);
+                x[i] = sample.getX();
+                y[i] = sample.getY();
+                z[i] = sample.getZ();
+            }
+        });
+        const double objectNs = bestNsPerSample(samples, repetitions, [&] {
+            for (size_t i = 0; i < samples; ++i) {
+                objects[i].parseRawData(raw.data() + i * 6, 6, scale);
+            }
+        });
+
+        bool equal = batch.size() == samples;
+        for (size_t i = 0; equal && i < samples; ++i) {
+            equal = batch[i] == objects[i] && batch[i] == mb::Accelerometer(x[i], y[i], z[i]);
+        }
+
+        std::printf("%9zu samples (%6.1f MB raw + float)  append %5.2f ns  into arrays %5.2f ns (%4.1fx)"
+                    "  into objects %5.2f ns (%4.1fx)  %s\n",
+                    samples, static_cast<double>(samples) * 18 / 1e6, batchNs, arraysNs, arraysNs / batchNs,
+                    objectNs, objectNs / batchNs, equal ? "values equal" : "VALUES DIFFER");
+        return equal;
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t cached = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    const size_t large = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 4194304;
+
+    std::printf("SIMD path: %s, ns per sample (best run)\n", mb::AccelerometerBatch::simdPath());
+    bool ok = run(cached, 20000);
+    ok = run(large, 20) && ok;
+    return ok ? 0 : 1;
+}
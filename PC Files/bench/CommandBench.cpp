@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file CommandBench.cpp
+ * @brief Compares the firmware's perfect-hash command dispatch with the strcmp chain it replaced.
+ *
+ * The table holds the same command words, in the same order and with the same slot count, as
+ * CommunicationModuleMCU::COMMANDS, and is hashed with the firmware's CommandHash.hpp. The
+ * chain compares the word with every entry in turn, as the old if/else chain in
+ * executeCommand() did. Host timings; on the Cortex-M0+ each strcmp of the chain costs more.
+ *
+ * Usage: CommandBench [lookups per command]   (default 5000000)
+ */
+
+#include "CommandHash.hpp"
+#include "CommunicationModuleBase.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+    /**
+     * @struct CommandTable
+     * @brief Firmware command words (the names are protected members of CommunicationModule).
+     */
+    struct CommandTable : CommunicationModule {
+        struct Entry {
+            const char *name;
+        };
+
+        static constexpr Entry COMMANDS[] = {
+            {PING}, {RESET}, {GET_SYSTEM_INFO}, {READ_TEMPERATURE}, {READ_TOUCH}, {SET_TOUCH},
+            {SET_LED_COLOR_RED}, {SET_LED_COLOR_GREEN}, {SET_LED_COLOR_BLUE}, {READ_ACCELERATION},
+            {READ_ACCEL_BATCH}, {SET_ACCEL_RES}, {SET_ACCEL_RANGE}, {READ_ACCEL_RANGE}, {SET_BINARY_MODE},
+            {SUBSCRIBE}, {UNSUBSCRIBE}
+        };
+        static constexpr size_t COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+        static constexpr auto HASH = mb::CommandHash::build<32>(COMMANDS);
+        static_assert(HASH.valid, "Command names collide in the hash table");
+    };
+
+    /**
+     * @brief Old dispatch: compares the word with every command until one matches.
+     * @return Command index or -1.
+     */
+    BENCH_NOINLINE int chainLookup(const char *command) {
+        for (size_t i = 0; i < CommandTable::COUNT; ++i) {
+            if (std::strcmp(command, CommandTable::COMMANDS[i].name) == 0) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Current dispatch: one hash, one slot read and one confirming compare.
+     * @return Command index or -1.
+     */
+    BENCH_NOINLINE int hashLookup(const char *command) {
+        const size_t length = mb::CommandHash::wordLength(command);
+        const uint8_t index = CommandTable::HASH.find(command, length);
+        if (index == 0 || std::strncmp(CommandTable::COMMANDS[index - 1].name, command, length) != 0
+            || CommandTable::COMMANDS[index - 1].name[length] != '\0') {
+            return -1;
+        }
+        return index - 1;
+    }
+
+    /**
+     * @brief Returns the average time of one lookup in nanoseconds.
+     */
+    double nsPerLookup(int (*lookup)(const char *), const char *command, long lookups, int &result) {
+        char buffer[32];
+        std::strncpy(buffer, command, sizeof(buffer) - 1);
+        buffer[sizeof(buffer) - 1] = '\0';
+
+        // Read through a volatile pointer so the lookup cannot be hoisted out of the loop
+        const char *volatile input = buffer;
+        volatile int sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < lookups; ++i) {
+            sink = sink + lookup(input);
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        result = lookup(buffer);
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(lookups);
+    }
+}
+
+int main(int argc, char **argv) {
+    const long lookups = (argc > 1) ? std::strtol(argv[1], nullptr, 10) : 5000000;
+    const char *commands[] = {"ping", "readaccel", "setledcolorblue", "unsubscribe", "bogus", "readaccelx"};
+    bool agree = true;
+
+    std::printf("seed=%u, ns per lookup\n", static_cast<unsigned>(CommandTable::HASH.seed));
+    std::printf("%-18s %12s %12s\n", "command", "strcmp chain", "perfect hash");
+    for (const char *command : commands) {
+        int chainResult = 0;
+        int hashResult = 0;
+        const double chainNs = nsPerLookup(chainLookup, command, lookups, chainResult);
+        const double hashNs = nsPerLookup(hashLookup, command, lookups, hashResult);
+        std::printf("%-18s %12.2f %12.2f\n", command, chainNs, hashNs);
+        agree = agree && chainResult == hashResult;
+    }
+    return agree ? 0 : 1;
+}
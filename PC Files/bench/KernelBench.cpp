@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file KernelBench.cpp
+ * @brief Compares the AccelerationKernels with per-sample loops, and the sqrt-free ordering
+ *        operators with the sqrt-based ones they replaced.
+ *
+ * The kernel results are checked against the scalar formula before they are timed.
+ *
+ * Usage: KernelBench [samples]   (default 65536)
+ */
+
+#include "AccelerometerBatch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int REPETITIONS = 200;
+    constexpr float THRESHOLD = 4.0f; /**< Magnitude threshold in g. */
+
+    volatile size_t sink = 0; /**< Keeps the timed results alive. */
+
+    /**
+     * @brief Legacy operator<=: compares magnitudes, each with its own square root.
+     */
+    bool legacyLessEqual(const mb::Accelerometer &a, const mb::Accelerometer &b) {
+        if (a.magnitude() < b.magnitude()) {
+            return true;
+        }
+        return std::fabs(a.magnitude() - b.magnitude()) <= 1e-5f;
+    }
+
+    /**
+     * @brief Prints the average time per sample of a repeated body.
+     */
+    template <typename Body>
+    void bench(const char *name, size_t samples, Body &&body) {
+        const auto start = Clock::now();
+        for (int rep = 0; rep < REPETITIONS; ++rep) {
+            body();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::printf("  %-32s %6.2f ns/sample\n", name, ns / (static_cast<double>(REPETITIONS) * samples));
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t samples = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 65536;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> axis(-8.0f, 8.0f);
+    mb::AccelerometerBatch batch(samples);
+    std::vector<mb::Accelerometer> objects;
+    objects.reserve(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        objects.emplace_back(axis(rng), axis(rng), axis(rng));
+        batch.push_back(objects.back());
+    }
+
+    std::vector<float> out(samples);
+    std::vector<uint8_t> flags(samples);
+
+    // The kernels must agree with the scalar formula
+    size_t mismatches = 0;
+    batch.squaredMagnitudes(out.data());
+    const size_t marked = batch.markAbove(THRESHOLD, flags.data());
+    size_t expected = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        const float x = objects[i].getX();
+        const float y = objects[i].getY();
+        const float z = objects[i].getZ();
+        const float squared = x * x + y * y + z * z;
+        const bool above = squared > THRESHOLD * THRESHOLD;
+        expected += above ? 1 : 0;
+        mismatches += (out[i] != squared || flags[i] != (above ? 1 : 0)) ? 1 : 0;
+    }
+    mismatches += (marked != expected || batch.countAbove(THRESHOLD) != expected) ? 1 : 0;
+
+    std::printf("SIMD path: %s, %zu samples, %zu mismatches\n", mb::AccelerometerBatch::simdPath(), samples,
+                mismatches);
+
+    bench("per-sample magnitude() loop", samples, [&] {
+        for (size_t i = 0; i < samples; ++i) {
+            out[i] = batch[i].magnitude();
+        }
+        sink = sink + static_cast<size_t>(out[samples - 1]);
+    });
+    bench("magnitudes()", samples, [&] {
+        batch.magnitudes(out.data());
+        sink = sink + static_cast<size_t>(out[samples - 1]);
+    });
+    bench("squaredMagnitudes()", samples, [&] {
+        batch.squaredMagnitudes(out.data());
+        sink = sink + static_cast<size_t>(out[samples - 1]);
+    });
+    bench("per-sample count |v| > t", samples, [&] {
+        size_t count = 0;
+        for (size_t i = 0; i < samples; ++i) {
+            count += (batch[i].magnitude() > THRESHOLD) ? 1 : 0;
+        }
+        sink = sink + count;
+    });
+    bench("countAbove()", samples, [&] { sink = sink + batch.countAbove(THRESHOLD); });
+    bench("markAbove()", samples, [&] { sink = sink + batch.markAbove(THRESHOLD, flags.data()); });
+
+    bench("legacy operator< (sqrt)", samples, [&] {
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            count += (objects[i - 1].magnitude() < objects[i].magnitude()) ? 1 : 0;
+        }
+        sink = sink + count;
+    });
+    bench("operator<", samples, [&] {
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            count += (objects[i - 1] < objects[i]) ? 1 : 0;
+        }
+        sink = sink + count;
+    });
+    bench("legacy operator<= (sqrt)", samples, [&] {
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            count += legacyLessEqual(objects[i - 1], objects[i]) ? 1 : 0;
+        }
+        sink = sink + count;
+    });
+    bench("operator<=", samples, [&] {
+        size_t count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            count += (objects[i - 1] <= objects[i]) ? 1 : 0;
+        }
+        sink = sink + count;
+    });
+
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file ParseBench.cpp
+ * @brief Compares AccelerationText with the strtok/atoi parsing it replaced.
+ *
+ * A capture of random sample lines (every 8th in the 8-bit layout) is generated in memory and
+ * parsed by both paths, once parsing only and once followed by Accelerometer::parseRawData().
+ * The legacy path copies each line (strtok writes into its input), tokenizes it with strtok and
+ * converts with atoi, as processRawAcceleration() did.
+ *
+ * Usage: ParseBench [lines]   (default 2000000)
+ */
+
+#include "AccelerationText.hpp"
+#include "BasicAccelerometer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Legacy path: copy the line, split it with strtok and convert every token with atoi.
+     * @return Number of values (6 or 3) or 0 if the line is not a sample.
+     */
+    int legacyParseLine(const char *begin, size_t length, uint8_t *data) {
+        char line[64];
+        length = (length < sizeof(line) - 1) ? length : sizeof(line) - 1;
+        std::memcpy(line, begin, length);
+        line[length] = '\0';
+
+        int index = 0;
+        char *token = std::strtok(line, " \r");
+        while (token != nullptr && index < 6) {
+            data[index++] = static_cast<uint8_t>(std::atoi(token));
+            token = std::strtok(nullptr, " \r");
+        }
+        return (index == 6 || index == 3) ? index : 0;
+    }
+
+    /**
+     * @brief Runs the legacy path over every line of the capture.
+     */
+    template <typename Sink>
+    size_t legacyParseLines(const std::string &capture, Sink &&sink) {
+        const char *cursor = capture.data();
+        const char *end = cursor + capture.size();
+        size_t samples = 0;
+        uint8_t data[6];
+
+        while (const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor))) {
+            if (int length = legacyParseLine(cursor, static_cast<size_t>(newline - cursor), data)) {
+                sink(data, static_cast<size_t>(length));
+                ++samples;
+            }
+            cursor = newline + 1;
+        }
+        return samples;
+    }
+
+    double nsPerLine(Clock::time_point start, Clock::time_point stop, size_t lines) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(lines);
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t lines = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    std::mt19937 rng(1);
+    std::string capture;
+    capture.reserve(lines * 20);
+    for (size_t i = 0; i < lines; ++i) {
+        const int values = (i % 8 == 0) ? 3 : 6;
+        for (int j = 0; j < values; ++j) {
+            if (j != 0) {
+                capture += ' ';
+            }
+            capture += std::to_string(rng() % 256);
+        }
+        capture += "\n\r"; // The MCU's line ending
+    }
+
+    const float scale = mb::Accelerometer::scaleForRange(2);
+    volatile uint8_t byteSink = 0;
+    float legacySum = 0.0f;
+    float currentSum = 0.0f;
+    size_t currentSamples = 0;
+
+    // Parsing only
+    auto t0 = Clock::now();
+    size_t legacySamples = legacyParseLines(capture, [&](const uint8_t *data, size_t) { byteSink = data[0]; });
+    auto t1 = Clock::now();
+    mb::AccelerationText::parseLines(capture, [&](const uint8_t *data, size_t) { byteSink = data[0]; }, &currentSamples);
+    auto t2 = Clock::now();
+    const double legacyParse = nsPerLine(t0, t1, lines);
+    const double currentParse = nsPerLine(t1, t2, lines);
+
+    // Parsing followed by conversion to g
+    t0 = Clock::now();
+    legacyParseLines(capture, [&](const uint8_t *data, size_t length) {
+        mb::Accelerometer accel;
+        if (accel.parseRawData(data, length, scale)) {
+            legacySum += accel.getZ();
+        }
+    });
+    t1 = Clock::now();
+    mb::AccelerationText::parseLines(capture, [&](const uint8_t *data, size_t length) {
+        mb::Accelerometer accel;
+        if (accel.parseRawData(data, length, scale)) {
+            currentSum += accel.getZ();
+        }
+    });
+    t2 = Clock::now();
+    const double legacyFull = nsPerLine(t0, t1, lines);
+    const double currentFull = nsPerLine(t1, t2, lines);
+
+    std::printf("lines=%zu bytes=%zu samples legacy=%zu current=%zu sums %s\n", lines, capture.size(),
+                legacySamples, currentSamples, (legacySum == currentSum) ? "equal" : "DIFFER");
+    std::printf("%-26s %12s %12s %9s\n", "ns/line", "strtok/atoi", "from_chars", "speed-up");
+    std::printf("%-26s %12.1f %12.1f %8.1fx\n", "parse only", legacyParse, currentParse, legacyParse / currentParse);
+    std::printf("%-26s %12.1f %12.1f %8.1fx\n", "parse + parseRawData", legacyFull, currentFull, legacyFull / currentFull);
+    return (legacySamples == currentSamples && legacySum == currentSum) ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file ProtocolBench.cpp
+ * @brief Wire bytes per accelerometer sample, and the sample rate they allow, for every way of
+ *        getting samples from the board in text and binary mode.
+ *
+ * The text lines are formatted like the firmware does (decimal bytes separated by spaces, "\n\r"
+ * line ending), the binary frames are built with BinaryProtocol::encodeFrame() and decoded back
+ * to check them. Samples are random, so the decimal lengths cover 1 to 3 digits. The sample rate
+ * is the UART limit at 9600 baud 8N1 (960 bytes/s), both directions counted; the accelerometer
+ * output data rate is a separate limit.
+ *
+ * Usage: ProtocolBench [samples]   (default 100000)
+ */
+
+#include "BinaryProtocol.hpp"
+#include "CommunicationModuleBase.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr double BYTES_PER_SECOND = 9600.0 / 10.0; /**< 8N1: start + 8 data + stop bits per byte. */
+    constexpr size_t SAMPLE_SIZE = 6;                  /**< Raw 14-bit X/Y/Z bytes. */
+    constexpr size_t BATCH_SAMPLES = 32;               /**< A full capture ring (MMA8451::RING_SIZE). */
+
+    size_t frames = 0;    /**< Binary frames built. */
+    size_t badFrames = 0; /**< Frames that did not decode back to their payload. */
+
+    /**
+     * @struct WireCost
+     * @brief Byte counts of the text and binary exchanges (the IDs are protected members of CommunicationModule).
+     */
+    struct WireCost : CommunicationModule {
+        /**
+         * @brief Builds a frame, checks that it decodes to the payload and returns its size.
+         */
+        static size_t frame(const uint8_t *payload, size_t length) {
+            uint8_t encoded[mb::BinaryProtocol::maxFrameSize(4 + BATCH_SAMPLES * SAMPLE_SIZE)];
+            uint8_t decoded[sizeof(encoded)];
+            const size_t size = mb::BinaryProtocol::encodeFrame(payload, length, encoded);
+            const size_t decodedLength = mb::BinaryProtocol::decodeFrame(encoded, size - 1, decoded, sizeof(decoded));
+            ++frames;
+            if (decodedLength != length || std::memcmp(decoded, payload, length) != 0) {
+                ++badFrames;
+            }
+            return size;
+        }
+
+        /**
+         * @brief Length of a text line holding the sample as the firmware formats it, with "\n\r".
+         */
+        static size_t sampleLine(const uint8_t *sample) {
+            char line[32];
+            int length = std::snprintf(line, sizeof(line), "%u %u %u %u %u %u", sample[0], sample[1], sample[2],
+                                       sample[3], sample[4], sample[5]);
+            return static_cast<size_t>(length) + 2;
+        }
+
+        /** "readaccel\r\n", then one sample line. */
+        static size_t textPoll(const uint8_t *sample) {
+            return std::strlen(READ_ACCELERATION) + 2 + sampleLine(sample);
+        }
+
+        /** "!readaccel <time> <sample>\n\r", pushed by a subscription. */
+        static size_t textStream(const uint8_t *sample, uint32_t timestampMs) {
+            char prefix[32];
+            int length = std::snprintf(prefix, sizeof(prefix), "%c%s %u ", STREAM_MARKER, READ_ACCELERATION,
+                                       static_cast<unsigned>(timestampMs));
+            return static_cast<size_t>(length) + sampleLine(sample);
+        }
+
+        /** "readaccelbatch\r\n", then "Samples: <n>\n\r" and n sample lines. */
+        static size_t textBatch(const uint8_t *samples, size_t count) {
+            char header[32];
+            size_t bytes = std::strlen(READ_ACCEL_BATCH) + 2;
+            bytes += static_cast<size_t>(std::snprintf(header, sizeof(header), "%s %zu", ACCEL_BATCH_HEADER, count)) + 2;
+            for (size_t i = 0; i < count; ++i) {
+                bytes += sampleLine(samples + i * SAMPLE_SIZE);
+            }
+            return bytes;
+        }
+
+        /** Request [ID][seq], response [ID | 0x80][seq][status][sample]. */
+        static size_t binaryPoll(const uint8_t *sample, uint8_t sequence) {
+            const uint8_t request[] = {BIN_READ_ACCELERATION, sequence};
+            uint8_t response[3 + SAMPLE_SIZE] = {static_cast<uint8_t>(BIN_READ_ACCELERATION | BIN_RESPONSE_FLAG),
+                                                 sequence, BIN_STATUS_OK};
+            std::memcpy(response + 3, sample, SAMPLE_SIZE);
+            return frame(request, sizeof(request)) + frame(response, sizeof(response));
+        }
+
+        /** Pushed [BIN_STREAM_SAMPLE][sensor][time, 4 bytes][sample]. */
+        static size_t binaryStream(const uint8_t *sample, uint32_t timestampMs) {
+            uint8_t payload[6 + SAMPLE_SIZE] = {BIN_STREAM_SAMPLE, BIN_READ_ACCELERATION,
+                                                static_cast<uint8_t>(timestampMs >> 24),
+                                                static_cast<uint8_t>(timestampMs >> 16),
+                                                static_cast<uint8_t>(timestampMs >> 8),
+                                                static_cast<uint8_t>(timestampMs)};
+            std::memcpy(payload + 6, sample, SAMPLE_SIZE);
+            return frame(payload, sizeof(payload));
+        }
+
+        /** Request [ID][seq], response [ID | 0x80][seq][status][count][count x sample]. */
+        static size_t binaryBatch(const uint8_t *samples, size_t count, uint8_t sequence) {
+            const uint8_t request[] = {BIN_READ_ACCEL_BATCH, sequence};
+            uint8_t response[4 + BATCH_SAMPLES * SAMPLE_SIZE] = {
+                    static_cast<uint8_t>(BIN_READ_ACCEL_BATCH | BIN_RESPONSE_FLAG), sequence, BIN_STATUS_OK,
+                    static_cast<uint8_t>(count)};
+            std::memcpy(response + 4, samples, count * SAMPLE_SIZE);
+            return frame(request, sizeof(request)) + frame(response, 4 + count * SAMPLE_SIZE);
+        }
+    };
+
+    /**
+     * @brief Prints one row: average bytes per sample, the UART sample rate and the gain over text polling.
+     */
+    void report(const char *name, double bytes, size_t samples, double textPollBytes) {
+        const double perSample = bytes / static_cast<double>(samples);
+        std::printf("%-26s %9.2f %12.1f %8.2fx\n", name, perSample, BYTES_PER_SECOND / perSample,
+                    textPollBytes / perSample);
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t samples = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    samples -= samples % BATCH_SAMPLES;
+    if (samples == 0) {
+        return 1;
+    }
+
+    std::mt19937 rng(3);
+    std::vector<uint8_t> raw(samples * SAMPLE_SIZE);
+    for (auto &byte : raw) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    double textPoll = 0;
+    double textStream = 0;
+    double textBatch = 0;
+    double binaryPoll = 0;
+    double binaryStream = 0;
+    double binaryBatch = 0;
+    uint32_t timestampMs = 1000000; // About 17 minutes after reset, 7 digits
+
+    for (size_t i = 0; i < samples; ++i, timestampMs += 10) {
+        const uint8_t *sample = raw.data() + i * SAMPLE_SIZE;
+        textPoll += static_cast<double>(WireCost::textPoll(sample));
+        textStream += static_cast<double>(WireCost::textStream(sample, timestampMs));
+        binaryPoll += static_cast<double>(WireCost::binaryPoll(sample, static_cast<uint8_t>(i)));
+        binaryStream += static_cast<double>(WireCost::binaryStream(sample, timestampMs));
+    }
+    for (size_t i = 0; i < samples; i += BATCH_SAMPLES) {
+        const uint8_t *batch = raw.data() + i * SAMPLE_SIZE;
+        textBatch += static_cast<double>(WireCost::textBatch(batch, BATCH_SAMPLES));
+        binaryBatch += static_cast<double>(WireCost::binaryBatch(batch, BATCH_SAMPLES, static_cast<uint8_t>(i)));
+    }
+
+    const double reference = textPoll / static_cast<double>(samples);
+    std::printf("%zu random samples, %zu frames checked, %zu bad\n", samples, frames, badFrames);
+    std::printf("%-26s %9s %12s %9s\n", "exchange", "bytes", "samples/s", "vs text");
+    report("text poll (readaccel)", textPoll, samples, reference);
+    report("binary poll", binaryPoll, samples, reference);
+    report("text stream", textStream, samples, reference);
+    report("binary stream", binaryStream, samples, reference);
+    report("text batch (32)", textBatch, samples, reference);
+    report("binary batch (32)", binaryBatch, samples, reference);
+    return (badFrames == 0) ? 0 : 1;
+}
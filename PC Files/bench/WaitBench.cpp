@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file WaitBench.cpp
+ * @brief Measures the CPU time spent waiting for a response, polling vs sleeping in the transport.
+ *
+ * A fake board on a pseudo-terminal answers every line 10 ms after receiving it. Each command
+ * is timed three ways:
+ * - polling: readSerialPort() without a timeout in a loop, as handleCommand() used to wait;
+ * - sleeping: readSerialPort() with the time left before the deadline;
+ * - handleCommand() itself.
+ * The two raw waits take the same wall time, but the waiting thread uses very different CPU
+ * time. handleCommand() also waits out its timeout for the extra lines it allows after some
+ * replies, so only its CPU time compares with the raw waits.
+ *
+ * Usage: WaitBench [commands]   (default 20, alternating ping and readaccel)
+ */
+
+#include "CommunicationModulePC.hpp"
+#include "SerialPort.hpp"
+
+#include <fcntl.h>
+#include <pty.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr unsigned int REPLY_DELAY_MS = 10; /**< Time the fake board takes to answer. */
+    constexpr unsigned int TIMEOUT_MS = 250;    /**< Response timeout of handleCommand(). */
+
+    /**
+     * @brief CPU time (user + system) consumed by the calling thread, in milliseconds.
+     */
+    double threadCpuMs() {
+        rusage usage{};
+        getrusage(RUSAGE_THREAD, &usage);
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3
+               + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+    }
+
+    /**
+     * @brief Board on the master side of a pseudo-terminal that answers every line after a delay.
+     */
+    class FakeBoard {
+    private:
+        int master;
+        std::atomic<bool> running{true};
+        std::thread thread;
+
+        void run() {
+            char line[64];
+            size_t used = 0;
+
+            while (running.load()) {
+                pollfd pending{master, POLLIN, 0};
+                char c;
+                if (poll(&pending, 1, 10) <= 0 || read(master, &c, 1) != 1) {
+                    continue;
+                }
+                if (c != '\n') {
+                    if (used + 1 < sizeof(line)) {
+                        line[used++] = c;
+                    }
+                    continue;
+                }
+                line[used] = '\0';
+                used = 0;
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(REPLY_DELAY_MS));
+                const char *reply = std::strstr(line, "range") ? "Range: 2g\n\r"
+                                    : std::strstr(line, "readaccel") ? "0 16 255 240 64 0\n\r"
+                                    : "PONG\n\r";
+                (void)!write(master, reply, std::strlen(reply));
+            }
+        }
+
+    public:
+        explicit FakeBoard(int master) : master(master) {
+            fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+            thread = std::thread([this] { run(); });
+        }
+
+        ~FakeBoard() {
+            running.store(false);
+            thread.join();
+        }
+    };
+
+    /**
+     * @brief Sends a command and waits for one reply line on the raw port.
+     * @param poll True to poll without a timeout (legacy), false to sleep in the transport.
+     */
+    bool exchange(SerialPort &port, const char *command, bool poll) {
+        char buffer[128];
+        size_t used = 0;
+        const int length = std::snprintf(buffer, sizeof(buffer), "%s\r\n", command);
+        port.writeSerialPort(buffer, static_cast<unsigned int>(length));
+
+        auto deadline = Clock::now() + std::chrono::milliseconds(TIMEOUT_MS);
+        while (Clock::now() < deadline) {
+            const auto remainingMs = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            const unsigned int timeoutMs = poll ? 0u : static_cast<unsigned int>(std::max<long long>(remainingMs, 0));
+            const int bytesRead = port.readSerialPort(buffer + used, sizeof(buffer) - 1 - used, timeoutMs);
+            if (bytesRead > 0) {
+                used += static_cast<size_t>(bytesRead);
+                if (std::memchr(buffer, '\n', used) != nullptr) {
+                    return true;
+                }
+                deadline = Clock::now() + std::chrono::milliseconds(TIMEOUT_MS);
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Runs the commands through a wait strategy and prints CPU and wall time per command.
+     */
+    template <typename Body>
+    void measure(const char *name, int commands, Body &&body) {
+        const double cpuStart = threadCpuMs();
+        const auto wallStart = Clock::now();
+        int answered = 0;
+        for (int i = 0; i < commands; ++i) {
+            answered += body((i % 2 == 0) ? "ping" : "readaccel") ? 1 : 0;
+        }
+        const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+        const double cpuMs = threadCpuMs() - cpuStart;
+        std::printf("%-28s cpu %7.2f ms  wall %6.1f ms  (%d/%d answered)\n", name, cpuMs / commands,
+                    wallMs / commands, answered, commands);
+    }
+}
+
+int main(int argc, char **argv) {
+    const int commands = (argc > 1) ? std::atoi(argv[1]) : 20;
+
+    int master = -1;
+    int slave = -1;
+    char name[64];
+    if (openpty(&master, &slave, name, nullptr, nullptr) != 0) {
+        std::perror("openpty");
+        return 1;
+    }
+    termios raw{};
+    tcgetattr(master, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(master, TCSANOW, &raw);
+
+    std::printf("Reply after %u ms, per command:\n", REPLY_DELAY_MS);
+    {
+        FakeBoard board(master);
+        {
+            SerialPort port(name, 9600, 0);
+            measure("polling readSerialPort()", commands, [&](const char *command) {
+                return exchange(port, command, true);
+            });
+            measure("sleeping readSerialPort()", commands, [&](const char *command) {
+                return exchange(port, command, false);
+            });
+        }
+
+        // handleCommand() prints every reply; keep the table readable
+        std::streambuf *console = std::cout.rdbuf(nullptr);
+        {
+            mb::CommunicationModulePC comm(name, 9600, mb::CommunicationModulePC::ConnectMode::Handshake, 2000);
+            measure("handleCommand()", commands, [&](const char *command) {
+                comm.handleCommand(command);
+                return true;
+            });
+        }
+        std::cout.rdbuf(console);
+    }
+
+    close(slave);
+    close(master);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file AccelerationText.hpp
+ * @brief Reentrant parser for the decimal accelerometer line format ("0 16 255 240 64 0").
+ */
+
+#ifndef ACCELERATION_TEXT_HPP
+#define ACCELERATION_TEXT_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace mb {
+
+/**
+ * @namespace AccelerationText
+ * @brief Non-mutating, allocation-free parsing of raw accelerometer bytes sent as decimal text.
+ *
+ * A line holds 6 (14-bit mode) or 3 (8-bit mode) values from 0 to 255 separated by spaces, in
+ * the byte layout Accelerometer::parseRawData() expects. The input is only read, so the same
+ * buffer can be parsed from several threads, and a whole capture can be parsed in one call.
+ */
+    namespace AccelerationText {
+
+        static constexpr size_t MAX_VALUES = 6; /**< Values in a 14-bit sample line. */
+
+        /**
+         * @brief Parses one line into raw sample bytes.
+         * @param line Line without its '\n'; a trailing '\r' and surrounding spaces are ignored.
+         * @param data Receives up to MAX_VALUES bytes.
+         * @param length Receives the number of bytes (6 or 3) on success.
+         * @return False if the line is not 3 or 6 space-separated values from 0 to 255.
+         */
+        inline bool parseLine(std::string_view line, uint8_t *data, uint8_t &length) {
+            const char *cursor = line.data();
+            const char *end = cursor + line.size();
+            size_t count = 0;
+
+            while (true) {
+                while (cursor != end && (*cursor == ' ' || *cursor == '\r')) {
+                    ++cursor;
+                }
+                if (cursor == end) {
+                    break;
+                }
+                if (count == MAX_VALUES) {
+                    return false; // More values than any sample layout has
+                }
+
+                // from_chars rejects signs, and values above 255 with result_out_of_range
+                uint8_t value = 0;
+                const auto result = std::from_chars(cursor, end, value);
+                if (result.ec != std::errc() || (result.ptr != end && *result.ptr != ' ' && *result.ptr != '\r')) {
+                    return false;
+                }
+                data[count++] = value;
+                cursor = result.ptr;
+            }
+
+            if (count != 6 && count != 3) {
+                return false;
+            }
+            length = static_cast<uint8_t>(count);
+            return true;
+        }
+
+        /**
+         * @brief Parses every complete line of a buffer, e.g. a chunk of an archived capture.
+         *
+         * Lines that do not parse (empty lines, replies, headers) are skipped. Bytes after the
+         * last '\n' are an incomplete line: they are not parsed, so the caller can prepend them
+         * to the next chunk.
+         *
+         * @tparam Sink Callable as sink(const uint8_t *data, size_t length) for every sample.
+         * @param buffer Text to parse.
+         * @param sink Receives the samples in order.
+         * @param samples Optional output number of samples passed to sink.
+         * @return Number of bytes consumed (up to and including the last '\n').
+         */
+        template <typename Sink>
+        size_t parseLines(std::string_view buffer, Sink &&sink, size_t *samples = nullptr) {
+            const char *begin = buffer.data();
+            const char *lineStart = begin;
+            const char *end = begin + buffer.size();
+            size_t parsed = 0;
+            uint8_t data[MAX_VALUES];
+            uint8_t length = 0;
+
+            while (lineStart != end) {
+                const char *lineEnd = static_cast<const char *>(std::memchr(lineStart, '\n', end - lineStart));
+                if (lineEnd == nullptr) {
+                    break; // Incomplete line
+                }
+                if (parseLine(std::string_view(lineStart, static_cast<size_t>(lineEnd - lineStart)), data, length)) {
+                    sink(static_cast<const uint8_t *>(data), static_cast<size_t>(length));
+                    ++parsed;
+                }
+                lineStart = lineEnd + 1;
+            }
+
+            if (samples != nullptr) {
+                *samples = parsed;
+            }
+            return static_cast<size_t>(lineStart - begin);
+        }
+
+    } // End of namespace AccelerationText
+
+} // End of namespace
+
+#endif // ACCELERATION_TEXT_HPP
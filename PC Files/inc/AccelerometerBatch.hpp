@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file AccelerometerBatch.hpp
+ * @brief Structure-of-arrays storage for many accelerometer samples with vectorized raw-to-g conversion.
+ */
+
+#ifndef ACCELEROMETER_BATCH_HPP
+#define ACCELEROMETER_BATCH_HPP
+
+#include "AccelerometerClass.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mb {
+
+/**
+ * @class AlignedAllocator
+ * @brief Minimal allocator returning storage aligned for the widest SIMD loads and stores.
+ * @tparam T Element type.
+ * @tparam Alignment Alignment in bytes, a power of two.
+ */
+    template <typename T, size_t Alignment>
+    class AlignedAllocator {
+    public:
+        using value_type = T; /**< Allocated element type. */
+
+        /**
+         * @brief Rebinds the allocator to another element type with the same alignment.
+         */
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>; /**< Allocator for U. */
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        /**
+         * @brief Converting constructor required by the allocator requirements.
+         */
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+        /**
+         * @brief Allocates storage for count elements.
+         * @param count Number of elements.
+         * @return Aligned storage.
+         */
+        T *allocate(size_t count) {
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        /**
+         * @brief Default-initializes instead of value-initializing, so resize() before the
+         *        conversion overwrites the elements does not zero them first.
+         * @param pointer Element to construct.
+         */
+        template <typename U>
+        void construct(U *pointer) noexcept {
+            ::new (static_cast<void *>(pointer)) U;
+        }
+
+        /**
+         * @brief Constructs an element from arguments (push_back(), copies).
+         * @param pointer Element to construct.
+         * @param args Constructor arguments.
+         */
+        template <typename U, typename... Args>
+        void construct(U *pointer, Args &&... args) {
+            ::new (static_cast<void *>(pointer)) U(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Releases storage returned by allocate().
+         * @param pointer Storage to release.
+         */
+        void deallocate(T *pointer, size_t) noexcept {
+            ::operator delete(pointer, std::align_val_t(Alignment));
+        }
+
+        /**
+         * @brief All instances are interchangeable.
+         */
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept { return true; }
+
+        /**
+         * @brief All instances are interchangeable.
+         */
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept { return false; }
+    };
+
+/**
+ * @namespace AccelerationKernels
+ * @brief Vectorized per-sample kernels over separate X, Y and Z arrays (e.g. those of an AccelerometerBatch).
+ *
+ * Like AccelerometerBatch::append(), the kernels use AVX2 or SSE2 as selected at compile time
+ * and a scalar loop for the tail. Threshold tests compare squared magnitudes, so they need no sqrt.
+ */
+    namespace AccelerationKernels {
+
+        /**
+         * @brief Computes x^2 + y^2 + z^2 for every sample.
+         * @param x X values (y and z likewise).
+         * @param count Number of samples.
+         * @param out Receives count squared magnitudes (may alias none of the inputs).
+         */
+        void squaredMagnitudes(const float *x, const float *y, const float *z, size_t count, float *out);
+
+        /**
+         * @brief Computes the magnitude of every sample.
+         * @param x X values (y and z likewise).
+         * @param count Number of samples.
+         * @param out Receives count magnitudes.
+         */
+        void magnitudes(const float *x, const float *y, const float *z, size_t count, float *out);
+
+        /**
+         * @brief Flags the samples whose magnitude exceeds a threshold.
+         * @param x X values (y and z likewise).
+         * @param count Number of samples.
+         * @param threshold Threshold in g.
+         * @param flags Receives 1 for every sample above the threshold and 0 otherwise.
+         * @return Number of samples above the threshold.
+         */
+        size_t markAbove(const float *x, const float *y, const float *z, size_t count, float threshold,
+                         uint8_t *flags);
+
+        /**
+         * @brief Counts the samples whose magnitude exceeds a threshold.
+         * @param x X values (y and z likewise).
+         * @param count Number of samples.
+         * @param threshold Threshold in g.
+         * @return Number of samples above the threshold.
+         */
+        size_t countAbove(const float *x, const float *y, const float *z, size_t count, float threshold);
+
+    } // End of namespace AccelerationKernels
+
+/**
+ * @class AccelerometerBatch
+ * @brief Many accelerometer samples stored as three separate, 32-byte aligned float arrays.
+ *
+ * Where Accelerometer holds one {x, y, z} sample, the batch keeps all X values, all Y values and
+ * all Z values contiguous, so kernels over one axis read consecutive memory and vectorize.
+ * append() converts big-endian raw samples in one pass: 8 samples per iteration with AVX2,
+ * 4 with SSE2, one at a time otherwise. The instruction set is chosen at compile time
+ * (see the JPO_ENABLE_AVX2 CMake option); simdPath() reports which one was built.
+ * Elements can still be read as Accelerometer objects through operator[]; magnitude and
+ * threshold queries run over the whole batch through AccelerationKernels.
+ */
+    class AccelerometerBatch {
+    public:
+        static constexpr size_t ALIGNMENT = 32; /**< Alignment of the axis arrays in bytes (one AVX register). */
+
+        using AxisArray = std::vector<float, AlignedAllocator<float, ALIGNMENT>>; /**< Storage of one axis. */
+
+    private:
+        AxisArray x; /**< X-axis accelerations in g. */
+        AxisArray y; /**< Y-axis accelerations in g. */
+        AxisArray z; /**< Z-axis accelerations in g. */
+
+    public:
+        /**
+         * @brief Constructs an empty batch.
+         */
+        AccelerometerBatch() = default;
+
+        /**
+         * @brief Constructs an empty batch with room for capacity samples.
+         * @param capacity Number of samples to reserve.
+         */
+        explicit AccelerometerBatch(size_t capacity) { reserve(capacity); }
+
+        /**
+         * @brief Reserves room for capacity samples, so appending up to it does not allocate.
+         * @param capacity Number of samples.
+         */
+        void reserve(size_t capacity);
+
+        /**
+         * @brief Removes all samples, keeping the capacity.
+         */
+        void clear();
+
+        /**
+         * @brief Returns the number of samples.
+         * @return Sample count.
+         */
+        size_t size() const { return x.size(); }
+
+        /**
+         * @brief Returns true if the batch holds no samples.
+         * @return True if empty.
+         */
+        bool empty() const { return x.empty(); }
+
+        /**
+         * @brief Converts raw samples to g and appends them.
+         * @param raw Samples back to back: 6 bytes each (14-bit X/Y/Z, MSB first) or 3 bytes each
+         *            (8-bit fast-read X/Y/Z MSBs), as in the accelerometer batch response.
+         * @param count Number of samples at raw.
+         * @param sampleSize Bytes per sample, 6 or 3.
+         * @param scale Scale of the active full-scale range, see Accelerometer::scaleForRange().
+         * @return False (nothing appended) if sampleSize is neither 6 nor 3.
+         */
+        bool append(const uint8_t *raw, size_t count, size_t sampleSize = 6,
+                    float scale = Accelerometer::scaleForRange(2));
+
+        /**
+         * @brief Appends one sample.
+         * @param sample Acceleration in g.
+         */
+        void push_back(const Accelerometer &sample);
+
+        /**
+         * @brief Returns a sample as an Accelerometer object.
+         * @param index Sample index, less than size().
+         * @return Copy of the sample.
+         */
+        Accelerometer operator[](size_t index) const { return Accelerometer(x[index], y[index], z[index]); }
+
+        /**
+         * @brief Writes the magnitude of every sample, see AccelerationKernels::magnitudes().
+         * @param out Receives size() magnitudes in g.
+         */
+        void magnitudes(float *out) const {
+            AccelerationKernels::magnitudes(x.data(), y.data(), z.data(), size(), out);
+        }
+
+        /**
+         * @brief Writes the squared magnitude of every sample, see AccelerationKernels::squaredMagnitudes().
+         * @param out Receives size() squared magnitudes in g^2.
+         */
+        void squaredMagnitudes(float *out) const {
+            AccelerationKernels::squaredMagnitudes(x.data(), y.data(), z.data(), size(), out);
+        }
+
+        /**
+         * @brief Flags the samples above a magnitude threshold, see AccelerationKernels::markAbove().
+         * @param threshold Threshold in g.
+         * @param flags Receives size() flags.
+         * @return Number of samples above the threshold.
+         */
+        size_t markAbove(float threshold, uint8_t *flags) const {
+            return AccelerationKernels::markAbove(x.data(), y.data(), z.data(), size(), threshold, flags);
+        }
+
+        /**
+         * @brief Counts the samples above a magnitude threshold, see AccelerationKernels::countAbove().
+         * @param threshold Threshold in g.
+         * @return Number of samples above the threshold.
+         */
+        size_t countAbove(float threshold) const {
+            return AccelerationKernels::countAbove(x.data(), y.data(), z.data(), size(), threshold);
+        }
+
+        /**
+         * @brief Returns the X-axis array.
+         * @return Pointer to size() aligned values in g.
+         */
+        const float *xData() const { return x.data(); }
+
+        /**
+         * @brief Returns the Y-axis array.
+         * @return Pointer to size() aligned values in g.
+         */
+        const float *yData() const { return y.data(); }
+
+        /**
+         * @brief Returns the Z-axis array.
+         * @return Pointer to size() aligned values in g.
+         */
+        const float *zData() const { return z.data(); }
+
+        /**
+         * @brief Returns the instruction set append() was built for.
+         * @return "AVX2", "SSE2" or "scalar".
+         */
+        static const char *simdPath();
+    };
+
+} // End of namespace
+
+#endif // ACCELEROMETER_BATCH_HPP
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file BinaryProtocol.hpp
+ * @brief COBS framing with CRC-16 shared by the MCU and PC sides of the binary protocol.
+ *
+ * Frame on the wire: COBS(payload + CRC16 big-endian) followed by a 0x00 delimiter.
+ * Request payload:  [command ID][sequence][arguments...]
+ * Response payload: [command ID | BIN_RESPONSE_FLAG][sequence][status][data...]
+ * Command IDs and status codes are defined in CommunicationModuleBase.hpp.
+ */
+
+#ifndef BINARY_PROTOCOL_HPP
+#define BINARY_PROTOCOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace mb {
+
+/**
+ * @namespace BinaryProtocol
+ * @brief Allocation-free frame encoding and decoding helpers.
+ */
+namespace BinaryProtocol
+{
+    static constexpr uint8_t FRAME_DELIMITER = 0x00; /**< Byte terminating every frame. */
+    static constexpr size_t CRC_SIZE = 2;            /**< Size of the CRC trailer in bytes. */
+
+    /**
+     * @brief Returns the worst-case encoded size of a frame including CRC and delimiter.
+     * @param payloadSize Payload size in bytes.
+     * @return Number of bytes encodeFrame() may write.
+     */
+    constexpr size_t maxFrameSize(size_t payloadSize)
+    {
+        return payloadSize + CRC_SIZE + (payloadSize + CRC_SIZE) / 254 + 2;
+    }
+
+    /**
+     * @brief Computes CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+     * @param data Pointer to the data.
+     * @param length Number of bytes.
+     * @return CRC value.
+     */
+    inline uint16_t crc16(const uint8_t* data, size_t length)
+    {
+        uint16_t crc = 0xFFFF;
+        while (length--)
+        {
+            crc ^= static_cast<uint16_t>(*data++) << 8;
+            for (uint8_t bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 0x8000u) ? static_cast<uint16_t>((crc << 1) ^ 0x1021u) : static_cast<uint16_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @class CobsEncoder
+     * @brief Incremental COBS encoder writing straight into the output buffer.
+     */
+    class CobsEncoder
+    {
+    private:
+        uint8_t* output;        /**< Destination buffer. */
+        size_t writeIndex = 1;  /**< Next position for a data byte. */
+        size_t codeIndex = 0;   /**< Position of the pending code byte. */
+        uint8_t code = 1;       /**< Distance to the next zero in the current block. */
+
+    public:
+        /**
+         * @brief Starts encoding into the given buffer.
+         * @param out Destination, at least n + n / 254 + 1 bytes for n input bytes.
+         */
+        explicit CobsEncoder(uint8_t* out) : output(out) {}
+
+        /**
+         * @brief Encodes one input byte.
+         * @param byte Byte to encode.
+         */
+        void put(uint8_t byte)
+        {
+            if (byte == 0)
+            {
+                output[codeIndex] = code;
+                code = 1;
+                codeIndex = writeIndex++;
+                return;
+            }
+            output[writeIndex++] = byte;
+            if (++code == 0xFF)
+            {
+                output[codeIndex] = code;
+                code = 1;
+                codeIndex = writeIndex++;
+            }
+        }
+
+        /**
+         * @brief Closes the last block.
+         * @return Number of encoded bytes written.
+         */
+        size_t finish()
+        {
+            output[codeIndex] = code;
+            return writeIndex;
+        }
+    };
+
+    /**
+     * @brief COBS-encodes data so that the output contains no 0x00 bytes.
+     * @param input Data to encode.
+     * @param length Number of bytes to encode.
+     * @param output Destination, at least length + length / 254 + 1 bytes.
+     * @return Number of bytes written.
+     */
+    inline size_t cobsEncode(const uint8_t* input, size_t length, uint8_t* output)
+    {
+        CobsEncoder encoder(output);
+        while (length--)
+        {
+            encoder.put(*input++);
+        }
+        return encoder.finish();
+    }
+
+    /**
+     * @brief Decodes a COBS block (without the trailing delimiter).
+     * @param input Encoded data.
+     * @param length Number of encoded bytes.
+     * @param output Destination buffer.
+     * @param outputSize Capacity of the destination buffer.
+     * @return Number of decoded bytes, or 0 if the input is malformed or does not fit.
+     */
+    inline size_t cobsDecode(const uint8_t* input, size_t length, uint8_t* output, size_t outputSize)
+    {
+        size_t readIndex = 0;
+        size_t writeIndex = 0;
+
+        while (readIndex < length)
+        {
+            uint8_t code = input[readIndex++];
+            if (code == 0)
+            {
+                return 0;
+            }
+            for (uint8_t i = 1; i < code; ++i)
+            {
+                if (readIndex >= length || writeIndex >= outputSize)
+                {
+                    return 0;
+                }
+                output[writeIndex++] = input[readIndex++];
+            }
+            if (code != 0xFF && readIndex < length)
+            {
+                if (writeIndex >= outputSize)
+                {
+                    return 0;
+                }
+                output[writeIndex++] = 0;
+            }
+        }
+        return writeIndex;
+    }
+
+    /**
+     * @brief Builds a complete frame: appends the CRC, COBS-encodes and adds the delimiter.
+     * @param payload Payload to send.
+     * @param length Payload size in bytes.
+     * @param output Destination, at least maxFrameSize(length) bytes.
+     * @return Number of bytes to transmit.
+     */
+    inline size_t encodeFrame(const uint8_t* payload, size_t length, uint8_t* output)
+    {
+        uint16_t crc = crc16(payload, length);
+        CobsEncoder encoder(output);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            encoder.put(payload[i]);
+        }
+        encoder.put(static_cast<uint8_t>(crc >> 8));
+        encoder.put(static_cast<uint8_t>(crc & 0xFF));
+
+        size_t encoded = encoder.finish();
+        output[encoded] = FRAME_DELIMITER;
+        return encoded + 1;
+    }
+
+    /**
+     * @brief Decodes a frame received without its delimiter and verifies the CRC.
+     * @param frame Encoded frame.
+     * @param length Encoded length.
+     * @param payload Destination for the payload (CRC is used as scratch space).
+     * @param payloadSize Capacity of the destination buffer.
+     * @return Payload size, or 0 if the frame is malformed or the CRC does not match.
+     */
+    inline size_t decodeFrame(const uint8_t* frame, size_t length, uint8_t* payload, size_t payloadSize)
+    {
+        size_t decoded = cobsDecode(frame, length, payload, payloadSize);
+        if (decoded <= CRC_SIZE)
+        {
+            return 0;
+        }
+
+        size_t dataLength = decoded - CRC_SIZE;
+        uint16_t received = static_cast<uint16_t>((payload[dataLength] << 8) | payload[dataLength + 1]);
+        return (crc16(payload, dataLength) == received) ? dataLength : 0;
+    }
+} // End of namespace BinaryProtocol
+
+} // End of namespace mb
+
+#endif // BINARY_PROTOCOL_HPP
@@ -11,6 +11,8 @@
 #ifndef COMMUNICATION_MODULE_BASE_HPP
 #define COMMUNICATION_MODULE_BASE_HPP
 
+#include <cstdint>
+
 /**
  * @class CommunicationModule
  * @brief Abstract interface for a communication module.
@@ -37,6 +39,64 @@ protected:
 
     // Accelerometer command
     inline static constexpr const char* READ_ACCELERATION   = "readaccel";
+    inline static constexpr const char* ACCEL_NO_SAMPLE     = "No accelerometer sample yet"; /**< readaccel answer before the first capture. */
+    inline static constexpr const char* READ_ACCEL_BATCH    = "readaccelbatch"; /**< Drains the captured accelerometer samples. */
+    inline static constexpr const char* ACCEL_BATCH_HEADER  = "Samples:"; /**< "Samples: <n>[ overflow]", then n readaccel lines. */
+    inline static constexpr const char* SET_ACCEL_RES       = "setaccelres"; /**< "setaccelres <8|14>": bits per axis in samples. */
+    inline static constexpr const char* ACCEL_RES_ACK       = "Resolution set!";
+    inline static constexpr const char* SET_ACCEL_RANGE     = "setaccelrange"; /**< "setaccelrange <2|4|8>": full-scale range in g. */
+    inline static constexpr const char* READ_ACCEL_RANGE    = "readaccelrange";
+    inline static constexpr const char* ACCEL_RANGE_HEADER  = "Range:"; /**< "Range: <g>g", the answer to both range commands. */
+
+    // Tagged request/response framing: "#XX cmd" -> "#XX:line" ... "#XX." (XX = hex sequence ID)
+    inline static constexpr char TAG_MARKER                 = '#';
+    inline static constexpr char TAG_LINE                   = ':';
+    inline static constexpr char TAG_END                    = '.';
+
+    // Binary protocol (COBS + CRC frames, see BinaryProtocol.hpp), entered with SET_BINARY_MODE
+    inline static constexpr const char* SET_BINARY_MODE     = "binmode";
+    inline static constexpr const char* BINARY_MODE_ACK     = "BINARY";
+    inline static constexpr const char* SET_TEXT_MODE       = "textmode"; /**< Text name of BIN_SET_TEXT_MODE. */
+
+    // Sensor streams: "subscribe <sensor> <periodMs>" / "unsubscribe [sensor]" (sensor = a read command).
+    // Samples are pushed as "!<sensor> <timeMs> <value>" lines until the stream is stopped.
+    inline static constexpr const char* SUBSCRIBE           = "subscribe";
+    inline static constexpr const char* UNSUBSCRIBE         = "unsubscribe"; /**< Without a sensor stops all streams. */
+    inline static constexpr const char* SUBSCRIBE_ACK       = "Subscribed!";
+    inline static constexpr const char* UNSUBSCRIBE_ACK     = "Unsubscribed!";
+    inline static constexpr char STREAM_MARKER              = '!';
+    inline static constexpr uint16_t MAX_STREAM_PERIOD_MS   = 60000;
+
+    // Binary command IDs, one per text command above
+    inline static constexpr uint8_t BIN_PING                = 0x01;
+    inline static constexpr uint8_t BIN_RESET               = 0x02;
+    inline static constexpr uint8_t BIN_GET_SYSTEM_INFO     = 0x03;
+    inline static constexpr uint8_t BIN_READ_TEMPERATURE    = 0x04;
+    inline static constexpr uint8_t BIN_READ_TOUCH          = 0x05;
+    inline static constexpr uint8_t BIN_SET_TOUCH           = 0x06;
+    inline static constexpr uint8_t BIN_SET_LED_COLOR_RED   = 0x07;
+    inline static constexpr uint8_t BIN_SET_LED_COLOR_GREEN = 0x08;
+    inline static constexpr uint8_t BIN_SET_LED_COLOR_BLUE  = 0x09;
+    inline static constexpr uint8_t BIN_READ_ACCELERATION   = 0x0A;
+    inline static constexpr uint8_t BIN_SUBSCRIBE           = 0x0B; /**< Arguments: sensor ID, period in ms (MSB first). */
+    inline static constexpr uint8_t BIN_UNSUBSCRIBE         = 0x0C; /**< Argument: sensor ID, none for all streams. */
+    inline static constexpr uint8_t BIN_READ_ACCEL_BATCH    = 0x0D; /**< Data: [count | BIN_BATCH_OVERFLOW][count x 6 (8-bit: 3) bytes]. */
+    inline static constexpr uint8_t BIN_SET_ACCEL_RES       = 0x0E; /**< Argument: bits per axis, 8 or 14. */
+    inline static constexpr uint8_t BIN_SET_ACCEL_RANGE     = 0x0F; /**< Argument: range in g (2, 4 or 8). Data: active range in g. */
+    inline static constexpr uint8_t BIN_READ_ACCEL_RANGE    = 0x10; /**< Data: active range in g. */
+    inline static constexpr uint8_t BIN_STREAM_SAMPLE       = 0x70; /**< Pushed: [ID][sensor ID][time ms, 4 bytes][data]. */
+    inline static constexpr uint8_t BIN_SET_TEXT_MODE       = 0x7F; /**< Leaves binary mode. */
+    inline static constexpr uint8_t BIN_ERROR               = 0x7E; /**< Response ID for undecodable frames. */
+
+    // Binary response flag and status codes
+    inline static constexpr uint8_t BIN_RESPONSE_FLAG       = 0x80;
+    inline static constexpr uint8_t BIN_BATCH_OVERFLOW      = 0x80; /**< Set in a batch count when captured samples were dropped. */
+    inline static constexpr uint8_t BIN_STATUS_OK           = 0x00;
+    inline static constexpr uint8_t BIN_STATUS_UNKNOWN      = 0x01;
+    inline static constexpr uint8_t BIN_STATUS_BAD_FRAME    = 0x02;
+    inline static constexpr uint8_t BIN_STATUS_BAD_ARGUMENT = 0x03;
+    inline static constexpr uint8_t BIN_STATUS_SENSOR_ERROR = 0x04; /**< The sensor did not answer (I2C NACK or timeout). */
+    inline static constexpr uint8_t BIN_STATUS_NO_SAMPLE    = 0x05; /**< The sensor answers but has not captured a sample yet. */
 
 public:
     /**
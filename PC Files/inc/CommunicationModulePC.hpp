@@ -12,10 +12,20 @@
 #define COMMUNICATION_MODULE_PC_HPP
 
 #include "CommunicationModuleBase.hpp"
+#include "AccelerometerClass.hpp"
+#include "AccelerometerBatch.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include "SerialPort.hpp"
+#include "SpscQueue.hpp"
 #include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <array>
 
 namespace mb {
 
@@ -24,10 +34,175 @@ namespace mb {
  * @brief Implements the communication interface for a PC connected to the FRDM-KL05Z via UART.
  */
     class CommunicationModulePC : public CommunicationModule {
+    public:
+        /**
+         * @enum ConnectMode
+         * @brief Selects how the module waits for the board after the port is opened.
+         */
+        enum class ConnectMode {
+            FixedDelay, /**< Sleep ARDUINO_WAIT_TIME ms after opening the port (legacy behaviour). */
+            Handshake   /**< Probe with PING until PONG arrives or the upper bound expires. */
+        };
+
+        /**
+         * @struct StreamSample
+         * @brief One sample pushed by a subscribed sensor stream.
+         */
+        struct StreamSample {
+            uint8_t sensor = 0;            /**< Binary ID of the sensor's read command (e.g. BIN_READ_ACCELERATION). */
+            uint32_t timestampMs = 0;      /**< MCU time of the sample in milliseconds. */
+            uint8_t length = 0;            /**< Number of valid bytes in data. */
+            std::array<uint8_t, 6> data{}; /**< Raw sample in the layout of the binary responses. */
+        };
+
     private:
-        SerialPort serial; /**< SerialPort object for low-level UART communication. */
+        SerialPort serial;            /**< SerialPort object for low-level UART communication. */
+        ConnectMode connectMode;      /**< Readiness strategy used by init(). */
+        unsigned int maxConnectMs;    /**< Upper bound for the readiness handshake in milliseconds. */
+        long long timeToReadyMs = -1; /**< Measured time until the board answered, -1 if not measured. */
+
+        static constexpr unsigned int PROBE_INTERVAL_MS = 50;    /**< Time to wait for PONG before re-sending PING. */
+        static constexpr unsigned int RESPONSE_TIMEOUT_MS = 250; /**< Time to wait for the next response line. */
+        static constexpr unsigned int BATCH_TIMEOUT_MS = 1000;   /**< Time to wait for a binary sample batch (~200 bytes at 9600 baud). */
+        static constexpr unsigned int READER_WAIT_MS = 20;       /**< Reader thread wait slice (bounds stopReader() latency). */
+        static constexpr size_t RESPONSE_QUEUE_SIZE = 256;       /**< Lines buffered between reader and consumer. */
+        static constexpr size_t STREAM_QUEUE_SIZE = 1024;        /**< Stream samples buffered until readStream(). */
+
+        SpscQueue<std::string, RESPONSE_QUEUE_SIZE> responses; /**< Framed lines published by the reader thread. */
+        std::thread readerThread;                              /**< Background thread draining the serial port. */
+        std::atomic<bool> readerRunning{false};                /**< True while the reader thread owns the receive path. */
+        std::atomic<bool> consumerWaiting{false};              /**< True while a consumer sleeps on responseReady. */
+        std::atomic<uint64_t> droppedLines{0};                 /**< Lines lost because the queue was full. */
+        std::mutex responseMutex;                              /**< Protects the responseReady wait only, not the queue. */
+        std::condition_variable responseReady;                 /**< Wakes a consumer after the reader published a line. */
+        std::string consumerLine;                              /**< Consumer-side buffer swapped with queue slots. */
+        SpscQueue<StreamSample, STREAM_QUEUE_SIZE> streamSamples; /**< Samples diverted from the response path. */
+        std::atomic<uint64_t> droppedSamples{0};               /**< Samples lost because the stream queue was full. */
+
+        /**
+         * @struct PendingReply
+         * @brief Reply lines collected for one tagged command that is still in flight.
+         */
+        struct PendingReply {
+            std::string command;            /**< Command text, used to post-process the reply. */
+            std::vector<std::string> lines; /**< Payload lines received so far (tag stripped). */
+            bool complete = false;          /**< True once the "#XX." end marker arrived. */
+        };
+
+        static constexpr size_t BINARY_PAYLOAD_MAX = 256;  /**< Largest decoded binary response payload. */
+
+        std::atomic<bool> binaryMode{false};         /**< True after setBinaryMode(true): frames are COBS + CRC. */
+        uint8_t nextSequence = 0;                    /**< Sequence number for the next binary request. */
+        bool taggedMode = false;                     /**< True if handleCommand() uses the tagged protocol. */
+        uint8_t nextTag = 0;                         /**< Sequence ID for the next tagged command. */
+        std::map<uint8_t, PendingReply> pendingReplies; /**< Tagged commands in flight, keyed by sequence ID. */
+        unsigned int accelRangeG = 2;                /**< Full-scale range the MCU last reported, in g. */
+        bool accelRangeKnown = false;                /**< True once accelRangeG came from the MCU or was asked for. */
+        float accelScale = Accelerometer::scaleForRange(2); /**< Precomputed parse scale for accelRangeG. */
+        AccelerometerBatch accelBatch;                      /**< Reused conversion buffer for batch responses. */
+
+        /**
+         * @brief Routes a received line to the pending reply with the matching tag.
+         * @param line Received line; untagged lines are printed as they are.
+         */
+        void dispatchTaggedLine(std::string_view line);
+
+        /**
+         * @brief Sends a text command as a binary request and prints the decoded response.
+         * @param cmd Text command (one of the constants in CommunicationModuleBase.hpp).
+         */
+        void handleBinaryCommand(const char *cmd);
+
+        /**
+         * @brief Prints a reply and parses acceleration data if the command was READ_ACCELERATION
+         *        or a sample line of READ_ACCEL_BATCH.
+         * @param cmd Command the reply belongs to.
+         * @param line Reply line.
+         */
+        void printResponse(const char *cmd, const char *line);
+
+        /**
+         * @brief Body of the reader thread: frames lines from the port and publishes them to the queue.
+         */
+        void readerLoop();
+
+        /**
+         * @brief Waits until the reader thread made the given condition true, or stopped.
+         * @param ready Condition checked after every wake-up.
+         * @param timeoutMs Maximum time to wait in milliseconds.
+         * @return True if the condition became true in time.
+         */
+        template <typename Ready>
+        bool waitForReader(Ready ready, unsigned int timeoutMs);
+
+        /**
+         * @brief Reads the next line (or COBS frame in binary mode) directly from the port.
+         * @param line Output view of the line, null-terminated and valid until the next read.
+         * @param timeoutMs Maximum time to wait in milliseconds.
+         * @return True if a line was received in time.
+         */
+        bool readIncoming(std::string_view &line, unsigned int timeoutMs);
+
+        /**
+         * @brief Queues the line as a stream sample if it is one ("!" line or BIN_STREAM_SAMPLE frame).
+         * @param line Received line or frame.
+         * @return True if the line was a stream sample and must not be treated as a response.
+         */
+        bool divertStreamSample(std::string_view line);
+
+        /**
+         * @brief Sends a text command and waits for its one-line acknowledgement.
+         * @param cmd Command to send.
+         * @param ack Expected reply; any other reply is printed.
+         * @param reply If not null, ack only has to be a prefix of the reply, which is stored here.
+         * @return True if the acknowledgement arrived in time.
+         */
+        bool sendAndAwaitAck(const char *cmd, const char *ack, std::string *reply = nullptr);
+
+        /**
+         * @brief Adopts a full-scale range reported by the MCU and precomputes its parse scale.
+         * @param rangeG Range in g.
+         * @return False if the range is not 2, 4 or 8 (the previous one is kept).
+         */
+        bool applyAccelerationRange(unsigned int rangeG);
+
+        /**
+         * @brief Asks the MCU for its accelerometer range once per session.
+         *
+         * Called before the first command that produces samples, so connecting stays a single
+         * round trip and the query never interleaves with the lines of another response.
+         */
+        void ensureAccelerationRange();
+
+        /**
+         * @brief Checks whether a command replies with accelerometer samples.
+         * @param cmd Text command.
+         * @return True for readaccel and readaccelbatch.
+         */
+        static bool requestsAccelerationSamples(const char *cmd);
+
+        /**
+         * @brief Returns the binary command ID for a text command.
+         * @param cmd Text command (one of the constants in CommunicationModuleBase.hpp).
+         * @return Binary command ID, or 0 if the command has no binary form.
+         */
+        static uint8_t binaryCommandId(std::string_view cmd);
+
+        /**
+         * @brief Returns the next response line (or COBS frame in binary mode) from the queue or the port.
+         * @param line Output view of the line, null-terminated and valid until the next call.
+         * @param timeoutMs Maximum time to wait in milliseconds.
+         * @return True if a line was received in time.
+         */
+        bool nextResponseLine(std::string_view &line, unsigned int timeoutMs);
 
     public:
+#ifdef _WIN32
+        inline static constexpr const char* DEFAULT_PORT = "COM6";         /**< Default port on Windows hosts. */
+#else
+        inline static constexpr const char* DEFAULT_PORT = "/dev/ttyACM0"; /**< Default port on Linux hosts (OpenSDA CDC). */
+#endif
+
         /**
          * @brief Default constructor for communication with default port and baud rate.
          */
@@ -35,27 +210,84 @@ namespace mb {
 
         /**
          * @brief Parameterized constructor for communication with custom port and baud rate.
-         * @param port COM port to connect to (in my example "COM6").
+         * @param port COM port to connect to (in my example "COM6", or a tty such as "/dev/ttyACM0" on Linux).
          * @param baudRate Baud rate for UART communication (In my example 9600).
          */
         CommunicationModulePC(const std::string &port, unsigned int baudRate = 9600);
 
+        /**
+         * @brief Constructor selecting how to wait for the board after opening the port.
+         * @param port COM port to connect to.
+         * @param baudRate Baud rate for UART communication.
+         * @param mode Readiness strategy (fixed delay or PING/PONG handshake).
+         * @param maxConnectMs Upper bound for the handshake in milliseconds.
+         */
+        CommunicationModulePC(const std::string &port, unsigned int baudRate, ConnectMode mode,
+                              unsigned int maxConnectMs = ARDUINO_WAIT_TIME);
+
         /**
          * @brief Destructor for releasing resources and closing the UART port.
          */
         ~CommunicationModulePC() override;
 
         /**
-         * @brief Clears the input buffer of the UART connection.
+         * @brief Clears the input buffer of the UART connection (or the response queue in reader mode).
          */
         void clearBuffer();
 
+        /**
+         * @brief Starts the background thread that continuously drains the serial port.
+         *
+         * While it runs, every received line is published to a bounded lock-free SPSC queue
+         * and nothing is discarded between commands. Lines are consumed with readResponse()
+         * or handleCommand() from a single application thread.
+         */
+        void startReader();
+
+        /**
+         * @brief Stops and joins the reader thread; reads go directly to the port again.
+         */
+        void stopReader();
+
+        /**
+         * @brief Returns true while the reader thread is running.
+         * @return Reader thread state.
+         */
+        bool isReaderRunning() const { return readerRunning.load(); }
+
+        /**
+         * @brief Consumer API: pops the next line published by the reader thread.
+         * @param line Receives the line; its previous buffer is recycled into the queue.
+         * @param timeoutMs Maximum time to wait in milliseconds (0 does not wait).
+         * @return True if a line was available in time.
+         */
+        bool readResponse(std::string &line, unsigned int timeoutMs);
+
+        /**
+         * @brief Returns the number of lines dropped because the consumer fell behind.
+         * @return Dropped line count since construction.
+         */
+        uint64_t getDroppedLines() const { return droppedLines.load(); }
+
         /**
          * @brief Initializes the communication module.
-         * @throws std::runtime_error if UART connection fails.
+         * @throws std::runtime_error if UART connection fails or the handshake times out.
          */
         void init() override;
 
+        /**
+         * @brief Probes the board with PING every PROBE_INTERVAL_MS until it answers PONG.
+         * @param maxWaitMs Upper bound for the handshake in milliseconds.
+         * @return True if the board answered in time; the elapsed time is stored for getTimeToReadyMs().
+         */
+        bool waitForBoard(unsigned int maxWaitMs);
+
+        /**
+         * @brief Returns the time the board needed to answer the readiness handshake.
+         * @return Time to ready in milliseconds, or -1 if no handshake was performed.
+         */
+        long long getTimeToReadyMs() const { return timeToReadyMs; }
+
         /**
          * @brief Sends a plain text message over UART.
          * @param text Null-terminated string to send.
@@ -69,8 +301,9 @@ namespace mb {
         void println(const char *text) override;
 
         /**
-         * @brief Receives data from UART as a null-terminated string.
-         * @return Pointer to the received data buffer.
+         * @brief Receives the next line from UART as a null-terminated string.
+         * @return Pointer into the transport's receive buffer (valid until the next read),
+         *         or an empty string if no complete line arrived within RESPONSE_TIMEOUT_MS.
          */
         char *receiveData() override;
 
@@ -80,6 +313,164 @@ namespace mb {
          */
         void handleCommand(const char *cmd) override;
 
+        /**
+         * @brief Enables or disables the tagged request/response protocol in handleCommand().
+         *
+         * In tagged mode every command is sent as "#XX cmd" and the reply is collected until
+         * the "#XX." end marker, so no input is cleared and no line count has to be guessed.
+         *
+         * @param enabled True to use tags.
+         */
+        void setTaggedMode(bool enabled) { taggedMode = enabled; }
+
+        /**
+         * @brief Returns true if handleCommand() uses the tagged protocol.
+         * @return Tagged mode state.
+         */
+        bool isTaggedMode() const { return taggedMode; }
+
+        /**
+         * @brief Sends a command with the next sequence tag without waiting for the reply.
+         * @param cmd Command to send.
+         * @return Sequence tag to pass to awaitTagged().
+         */
+        uint8_t sendTagged(const char *cmd);
+
+        /**
+         * @brief Waits for the complete reply of a tagged command; replies may arrive in any order.
+         * @param tag Sequence tag returned by sendTagged().
+         * @param lines Receives the reply lines without the tag prefix.
+         * @param timeoutMs Maximum time without any received line, in milliseconds.
+         * @return True if the end marker arrived in time.
+         */
+        bool awaitTagged(uint8_t tag, std::vector<std::string> &lines, unsigned int timeoutMs = RESPONSE_TIMEOUT_MS);
+
+        /**
+         * @brief Sends all commands back to back with tags, then prints every reply.
+         * @param commands Commands to pipeline.
+         */
+        void handleCommands(const std::vector<std::string> &commands);
+
+        /**
+         * @brief Switches the MCU and this module between the text and the binary protocol.
+         *
+         * Binary mode sends every command as a COBS frame with a CRC-16 and receives the
+         * sensor data as raw bytes (6 bytes per acceleration sample instead of up to 25
+         * ASCII characters), see BinaryProtocol.hpp.
+         *
+         * @param enabled True to enter binary mode, false to return to text mode.
+         * @return True if the MCU acknowledged the switch.
+         */
+        bool setBinaryMode(bool enabled);
+
+        /**
+         * @brief Returns true if the binary protocol is active.
+         * @return Binary mode state.
+         */
+        bool isBinaryMode() const { return binaryMode.load(); }
+
+        /**
+         * @brief Sends one binary request and waits for the response with the same sequence number.
+         * @param command Binary command ID (BIN_* in CommunicationModuleBase.hpp).
+         * @param data Receives the response data bytes.
+         * @param timeoutMs Maximum time to wait in milliseconds.
+         * @return True if a valid response with status OK arrived in time.
+         */
+        bool requestBinary(uint8_t command, std::vector<uint8_t> &data, unsigned int timeoutMs = RESPONSE_TIMEOUT_MS);
+
+        /**
+         * @brief Sends one binary request with arguments and waits for the matching response.
+         * @param command Binary command ID (BIN_* in CommunicationModuleBase.hpp).
+         * @param arguments Request arguments following the sequence number.
+         * @param data Receives the response data bytes.
+         * @param timeoutMs Maximum time to wait in milliseconds.
+         * @return True if a valid response with status OK arrived in time.
+         */
+        bool requestBinary(uint8_t command, const std::vector<uint8_t> &arguments, std::vector<uint8_t> &data,
+                           unsigned int timeoutMs = RESPONSE_TIMEOUT_MS);
+
+        /**
+         * @brief Asks the MCU to push samples of a sensor at a fixed period.
+         *
+         * Samples arrive without any request, in text mode as "!<sensor> <timeMs> <value>"
+         * lines and in binary mode as BIN_STREAM_SAMPLE frames. They are kept apart from
+         * command responses and consumed with readStream().
+         *
+         * @param sensor Read command of the sensor: "readaccel", "readtemp" or "readtouch".
+         * @param periodMs Sample period in milliseconds (1 to MAX_STREAM_PERIOD_MS).
+         * @return True if the MCU acknowledged the subscription.
+         */
+        bool subscribe(const char *sensor, unsigned int periodMs);
+
+        /**
+         * @brief Stops the stream of one sensor, or of all sensors.
+         * @param sensor Read command of the sensor, or nullptr for all streams.
+         * @return True if the MCU acknowledged the request.
+         */
+        bool unsubscribe(const char *sensor = nullptr);
+
+        /**
+         * @brief Sets the accelerometer full-scale range on the MCU.
+         *
+         * The MCU answers with the active range, which is then used to scale every
+         * acceleration parsed afterwards (responses, batches and stream samples).
+         *
+         * @param rangeG Range in g: 2, 4 or 8.
+         * @return True if the MCU applied the range.
+         */
+        bool setAccelerationRange(unsigned int rangeG);
+
+        /**
+         * @brief Asks the MCU for its accelerometer full-scale range and adopts it for parsing.
+         * @return True if the MCU reported a valid range.
+         */
+        bool queryAccelerationRange();
+
+        /**
+         * @brief Returns the full-scale range used to scale accelerations.
+         * @return Range in g.
+         */
+        unsigned int getAccelerationRange() const { return accelRangeG; }
+
+        /**
+         * @brief Selects the accelerometer sample resolution on the MCU.
+         *
+         * 8 bits uses the sensor's fast-read mode: every reading, batch entry and stream sample
+         * then carries 3 instead of 6 bytes, which parseRawData() accepts as well.
+         *
+         * @param bits 8 or 14.
+         * @return True if the MCU acknowledged the change.
+         */
+        bool setAccelerationResolution(unsigned int bits);
+
+        /**
+         * @brief Consumer API: takes the next stream sample, reading the port itself if no reader thread runs.
+         * @param sample Receives the sample.
+         * @param timeoutMs Maximum time to wait in milliseconds (0 does not wait).
+         * @return True if a sample was available in time.
+         */
+        bool readStream(StreamSample &sample, unsigned int timeoutMs);
+
+        /**
+         * @brief Returns the number of stream samples dropped because the consumer fell behind.
+         * @return Dropped sample count since construction.
+         */
+        uint64_t getDroppedSamples() const { return droppedSamples.load(); }
+
+        /**
+         * @brief Consumer API: converts an accelerometer stream sample to g with the current range, without allocating.
+         * @param sample Sample returned by readStream().
+         * @param accel Receives the acceleration.
+         * @return False if the sample is not an accelerometer sample or has an unexpected length.
+         */
+        bool parseStreamAcceleration(const StreamSample &sample, Accelerometer &accel) const;
+
+        /**
+         * @brief Prints a stream sample in the same format as the matching command response.
+         * @param sample Sample to print.
+         */
+        void printStreamSample(const StreamSample &sample) const;
+
         /**
          * @brief Processes raw acceleration data received from the microcontroller.
          * @param rawLine Null-terminated string containing raw data.
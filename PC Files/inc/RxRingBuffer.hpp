@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file RxRingBuffer.hpp
+ * @brief Contiguous receive buffer with an in-place line/frame splitter for the PC UART path.
+ */
+
+#ifndef RX_RING_BUFFER_HPP
+#define RX_RING_BUFFER_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace mb {
+
+/**
+ * @class RxRingBuffer
+ * @brief Receive buffer that the transport reads into directly and that hands out frames as views.
+ *
+ * Bytes are appended at the tail by the transport and consumed from the head by the framer.
+ * Instead of wrapping byte by byte, the buffer wraps by relocating the unconsumed partial frame
+ * to the front when the tail reaches the end, so every frame is contiguous and can be returned
+ * as a std::string_view without copying. The storage grows (up to a limit) when a single frame
+ * does not fit, so long lines are never truncated. Nothing is cleared between reads.
+ */
+    class RxRingBuffer {
+    private:
+        std::vector<char> storage; /**< Backing storage, allocated once and grown only for oversized frames. */
+        size_t head = 0;           /**< Offset of the first unconsumed byte. */
+        size_t tail = 0;           /**< Offset one past the last received byte. */
+        size_t scanned = 0;        /**< Offset up to which the data was already searched for a delimiter. */
+        char scannedFor = '\n';    /**< Delimiter the scanned range was searched for. */
+        size_t maxCapacity;        /**< Upper bound for the storage size. */
+        bool discarding = false;   /**< True while dropping the rest of a frame larger than maxCapacity. */
+
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 1024;      /**< Initial storage size in bytes. */
+        static constexpr size_t MAX_CAPACITY = 64 * 1024;     /**< Default upper bound for the storage size. */
+
+        /**
+         * @brief Constructs the buffer with the given initial and maximal capacity.
+         * @param capacity Initial storage size in bytes.
+         * @param maxCapacity Upper bound the storage may grow to for oversized frames.
+         */
+        explicit RxRingBuffer(size_t capacity = DEFAULT_CAPACITY, size_t maxCapacity = MAX_CAPACITY);
+
+        /**
+         * @brief Returns the free contiguous space at the tail, making room if the tail reached the end.
+         * @param available Output number of bytes that may be written at the returned pointer.
+         * @return Pointer where the transport should write received bytes.
+         */
+        char *writePointer(size_t &available);
+
+        /**
+         * @brief Marks bytes written through writePointer() as received.
+         * @param count Number of bytes written.
+         */
+        void commit(size_t count);
+
+        /**
+         * @brief Extracts the next frame terminated by the given delimiter.
+         *
+         * The delimiter is replaced by '\0' in place, so the returned view is also a valid
+         * C string. The view stays valid until the next call to writePointer() or clear().
+         *
+         * @param frame Output view of the frame (without the delimiter).
+         * @param delimiter Byte terminating a frame.
+         * @return True if a complete frame was available.
+         */
+        bool nextFrame(std::string_view &frame, char delimiter);
+
+        /**
+         * @brief Extracts the next '\n'-terminated line with surrounding '\r' characters trimmed.
+         * @param line Output view of the line (null-terminated in place).
+         * @return True if a complete line was available.
+         */
+        bool nextLine(std::string_view &line);
+
+        /**
+         * @brief Returns the number of received but not yet consumed bytes.
+         * @return Pending byte count.
+         */
+        size_t size() const { return tail - head; }
+
+        /**
+         * @brief Drops all pending bytes.
+         */
+        void clear();
+    };
+
+} // End of namespace
+
+#endif // RX_RING_BUFFER_HPP
@@ -10,22 +10,43 @@
 #define ARDUINO_WAIT_TIME 2000
 #define MAX_DATA_LENGTH 255
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <iostream>
+#include <chrono>
+#include <string_view>
+#include "RxRingBuffer.hpp"
 
 class SerialPort
 {
 private:
+#ifdef _WIN32
     HANDLE handler;
-    bool connected;
     COMSTAT status;
     DWORD errors;
+    DWORD readTimeoutMs; // Read timeout currently programmed with SetCommTimeouts - Miroslaw Baca
+#else
+    int handler;   // File descriptor of the tty - Miroslaw Baca
+    int epollFd;   // epoll instance watching the tty for readability - Miroslaw Baca
+#endif
+    bool connected;
+    mb::RxRingBuffer rxBuffer; // Receive buffer owned by the transport, framed in place - Miroslaw Baca
+
+    bool fillRxBuffer(std::chrono::steady_clock::time_point deadline);
 public:
-    explicit SerialPort(const char *portName, int baudRate); // Added baudRate - Miroslaw Baca
+    // waitTimeMs: settle delay after opening, 0 lets the caller run its own readiness handshake - Miroslaw Baca
+    explicit SerialPort(const char *portName, int baudRate, unsigned int waitTimeMs = ARDUINO_WAIT_TIME); // Added baudRate - Miroslaw Baca
     ~SerialPort();
 
-    int readSerialPort(const char *buffer, unsigned int buf_size);
+    // timeoutMs == 0 returns immediately, otherwise waits up to timeoutMs for the first byte - Miroslaw Baca
+    int readSerialPort(const char *buffer, unsigned int buf_size, unsigned int timeoutMs = 0);
     bool writeSerialPort(const char *buffer, unsigned int buf_size);
+
+    // Zero-copy framed reads: the view points into rxBuffer and stays valid until the next read - Miroslaw Baca
+    bool readLine(std::string_view &line, unsigned int timeoutMs = 0);
+    bool readFrame(std::string_view &frame, char delimiter, unsigned int timeoutMs = 0);
+    void flushInput();
     bool isConnected();
     void closeSerial();
-};
\ No newline at end of file
+};
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file SpscQueue.hpp
+ * @brief Bounded lock-free single-producer/single-consumer queue.
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace mb {
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring of slots shared by exactly one producer and one consumer thread.
+ *
+ * Slots are reused in place: the producer fills the slot returned by producerSlot() and
+ * publishes it, the consumer reads the slot returned by consumerSlot() and releases it.
+ * With types such as std::string the slot keeps its capacity, so after warm-up pushing
+ * and popping does not allocate.
+ *
+ * @tparam T Slot type.
+ * @tparam Capacity Number of slots, must be a power of two.
+ */
+    template <typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    private:
+        static constexpr size_t CACHE_LINE = 64;   /**< Keeps the indices on separate cache lines. */
+        static constexpr size_t MASK = Capacity - 1;
+
+        alignas(CACHE_LINE) std::atomic<size_t> head{0}; /**< Next slot to consume (written by the consumer). */
+        alignas(CACHE_LINE) std::atomic<size_t> tail{0}; /**< Next slot to fill (written by the producer). */
+        alignas(CACHE_LINE) std::array<T, Capacity> slots{};
+
+    public:
+        /**
+         * @brief Producer: returns the next free slot, or nullptr if the queue is full.
+         * @return Pointer to the slot to fill before calling publish().
+         */
+        T *producerSlot() {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == Capacity) {
+                return nullptr;
+            }
+            return &slots[t & MASK];
+        }
+
+        /**
+         * @brief Producer: makes the slot filled through producerSlot() visible to the consumer.
+         */
+        void publish() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Consumer: returns the oldest published slot, or nullptr if the queue is empty.
+         * @return Pointer to the slot to read before calling release().
+         */
+        T *consumerSlot() {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &slots[h & MASK];
+        }
+
+        /**
+         * @brief Consumer: returns the slot obtained through consumerSlot() to the producer.
+         */
+        void release() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Producer: copies or moves a value into the next free slot.
+         * @param value Value to enqueue.
+         * @return False if the queue is full.
+         */
+        template <typename U>
+        bool push(U &&value) {
+            T *slot = producerSlot();
+            if (slot == nullptr) {
+                return false;
+            }
+            *slot = std::forward<U>(value);
+            publish();
+            return true;
+        }
+
+        /**
+         * @brief Consumer: takes the oldest value by swapping it with the caller's object.
+         *
+         * Swapping hands the caller's previous storage back to the slot, so buffers circulate
+         * between producer and consumer instead of being reallocated.
+         *
+         * @param out Receives the dequeued value.
+         * @return False if the queue is empty.
+         */
+        bool pop(T &out) {
+            T *slot = consumerSlot();
+            if (slot == nullptr) {
+                return false;
+            }
+            using std::swap;
+            swap(out, *slot);
+            release();
+            return true;
+        }
+
+        /**
+         * @brief Returns true if no published slot is pending (exact only on the consumer side).
+         * @return True if the queue is empty.
+         */
+        bool empty() const {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Returns the number of slots in the queue.
+         * @return Queue capacity.
+         */
+        static constexpr size_t capacity() { return Capacity; }
+    };
+
+} // End of namespace
+
+#endif // SPSC_QUEUE_HPP
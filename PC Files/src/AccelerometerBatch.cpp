@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file AccelerometerBatch.cpp
+ * @brief Implementation of the structure-of-arrays accelerometer batch and its conversion and magnitude kernels.
+ */
+
+#include "AccelerometerBatch.hpp"
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ACCEL_BATCH_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ACCEL_BATCH_SSE2 1
+#endif
+
+namespace mb {
+
+    namespace {
+
+        /**
+         * @brief Converts samples one at a time (tail of the vector loops, 8-bit layout, other CPUs).
+         * @param raw First raw sample.
+         * @param count Number of samples.
+         * @param sampleSize Bytes per sample, 6 or 3.
+         * @param scale Scale in g per count of the left-justified 16-bit value.
+         * @param x Destination of the X values (y and z likewise).
+         */
+        void convertScalar(const uint8_t *raw, size_t count, size_t sampleSize, float scale,
+                           float *x, float *y, float *z) {
+            for (size_t i = 0; i < count; ++i, raw += sampleSize) {
+                if (sampleSize == 3) {
+                    // 8-bit fast-read layout: only the MSB of each axis, so it is the high byte of the 16-bit value
+                    x[i] = static_cast<int16_t>(raw[0] << 8) * scale;
+                    y[i] = static_cast<int16_t>(raw[1] << 8) * scale;
+                    z[i] = static_cast<int16_t>(raw[2] << 8) * scale;
+                } else {
+                    x[i] = static_cast<int16_t>((raw[0] << 8) | raw[1]) * scale;
+                    y[i] = static_cast<int16_t>((raw[2] << 8) | raw[3]) * scale;
+                    z[i] = static_cast<int16_t>((raw[4] << 8) | raw[5]) * scale;
+                }
+            }
+        }
+
+#if ACCEL_BATCH_SSE2
+        /**
+         * @brief Loads 8 bytes of two consecutive 6-byte samples into the two halves of a register.
+         *
+         * Each half holds x y and z x' of its sample (x' belongs to the next sample), so the
+         * load reads 2 bytes past the second sample.
+         */
+        inline __m128 loadSamplePair(const uint8_t *raw) {
+            const __m128 low = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw)));
+            return _mm_loadh_pi(low, reinterpret_cast<const __m64 *>(raw + 6));
+        }
+
+        /**
+         * @brief Swaps the bytes of every 16-bit word.
+         */
+        inline __m128i swapBytes(__m128i words) {
+            return _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+        }
+
+        /**
+         * @brief Converts 4 consecutive 6-byte samples (24 bytes, reads 2 more).
+         *
+         * The loads already put one sample per 32-bit lane: xy = x0y0 x1y1 x2y2 x3y3 and
+         * zx = z0x1 z1x2 z2x3 z3x4, so only two shuffles are needed instead of a transpose. After
+         * the byte swap each value is moved to the upper half of its lane, which sign-extends it
+         * as value * 65536; scale already includes the 1/65536.
+         */
+        inline void convert4(const uint8_t *raw, __m128 scale, float *x, float *y, float *z) {
+            const __m128 pair01 = loadSamplePair(raw);
+            const __m128 pair23 = loadSamplePair(raw + 12);
+            const __m128i xy = swapBytes(_mm_castps_si128(_mm_shuffle_ps(pair01, pair23, _MM_SHUFFLE(2, 0, 2, 0))));
+            const __m128i zx = swapBytes(_mm_castps_si128(_mm_shuffle_ps(pair01, pair23, _MM_SHUFFLE(3, 1, 3, 1))));
+            const __m128i upperHalf = _mm_set1_epi32(static_cast<int>(0xFFFF0000u));
+
+            _mm_storeu_ps(x, _mm_mul_ps(_mm_cvtepi32_ps(_mm_slli_epi32(xy, 16)), scale));
+            _mm_storeu_ps(y, _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(xy, upperHalf)), scale));
+            _mm_storeu_ps(z, _mm_mul_ps(_mm_cvtepi32_ps(_mm_slli_epi32(zx, 16)), scale));
+        }
+#endif
+
+#if ACCEL_BATCH_AVX2
+        /**
+         * @brief Converts 8 consecutive 6-byte samples (48 bytes).
+         *
+         * The 12 big-endian values of samples 0-3 and of samples 4-7 are byte-swapped and widened
+         * in place order, giving a = x0 y0 z0 x1, b = y1 z1 x2 y2 and c = z2 x3 y3 z3 in the low
+         * and the same for samples 4-7 in the high 128-bit lane, which are then transposed.
+         */
+        inline void convert8(const uint8_t *raw, __m256 scale, float *x, float *y, float *z) {
+            __m256i low = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(raw))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + 24)), 1);
+            __m256i high = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw + 16))),
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(raw + 40)), 1);
+            low = _mm256_or_si256(_mm256_slli_epi16(low, 8), _mm256_srli_epi16(low, 8));
+            high = _mm256_or_si256(_mm256_slli_epi16(high, 8), _mm256_srli_epi16(high, 8));
+
+            __m256 a = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_unpacklo_epi16(low, low), 16)), scale);
+            __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_unpackhi_epi16(low, low), 16)), scale);
+            __m256 c = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_unpacklo_epi16(high, high), 16)), scale);
+
+            __m256 b2b3c1c2 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+            __m256 a1a1b0b0 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+            __m256 a2a2b1b1 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+            __m256 c0c0c3c3 = _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+            _mm256_storeu_ps(x, _mm256_shuffle_ps(a, b2b3c1c2, _MM_SHUFFLE(2, 0, 3, 0)));
+            _mm256_storeu_ps(y, _mm256_shuffle_ps(a1a1b0b0, b2b3c1c2, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(z, _mm256_shuffle_ps(a2a2b1b1, c0c0c3c3, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+#endif
+
+        /**
+         * @brief Returns the squared magnitude threshold equivalent to a magnitude threshold.
+         *
+         * Every magnitude exceeds a negative threshold, so that maps to -1 (squared magnitudes are >= 0).
+         *
+         * @param threshold Threshold in g.
+         * @return Threshold in g^2.
+         */
+        inline float squaredThreshold(float threshold) {
+            return (threshold < 0.0f) ? -1.0f : threshold * threshold;
+        }
+
+#if ACCEL_BATCH_SSE2
+        /**
+         * @brief Computes the squared magnitudes of 4 consecutive samples.
+         */
+        inline __m128 squared4(const float *x, const float *y, const float *z) {
+            const __m128 vx = _mm_loadu_ps(x);
+            const __m128 vy = _mm_loadu_ps(y);
+            const __m128 vz = _mm_loadu_ps(z);
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+        }
+
+        /**
+         * @brief Adds the integer lanes of a vector.
+         */
+        inline size_t sumLanes(__m128i counts) {
+            counts = _mm_add_epi32(counts, _mm_shuffle_epi32(counts, _MM_SHUFFLE(1, 0, 3, 2)));
+            counts = _mm_add_epi32(counts, _mm_shuffle_epi32(counts, _MM_SHUFFLE(2, 3, 0, 1)));
+            return static_cast<uint32_t>(_mm_cvtsi128_si32(counts));
+        }
+#endif
+
+#if ACCEL_BATCH_AVX2
+        /**
+         * @brief Computes the squared magnitudes of 8 consecutive samples.
+         */
+        inline __m256 squared8(const float *x, const float *y, const float *z) {
+            const __m256 vx = _mm256_loadu_ps(x);
+            const __m256 vy = _mm256_loadu_ps(y);
+            const __m256 vz = _mm256_loadu_ps(z);
+            return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+        }
+#endif
+
+        /**
+         * @brief Tests samples against a threshold, optionally writing a flag per sample.
+         *
+         * Comparison results are all-ones lanes (-1), so subtracting them counts the samples above
+         * without leaving the vector registers; flags are the same lanes narrowed to bytes.
+         *
+         * @tparam WriteFlags True to write flags, false to only count.
+         * @param x X values (y and z likewise).
+         * @param count Number of samples.
+         * @param threshold Threshold in g.
+         * @param flags Receives one flag per sample if WriteFlags is true.
+         * @return Number of samples above the threshold.
+         */
+        template <bool WriteFlags>
+        size_t testAbove(const float *x, const float *y, const float *z, size_t count, float threshold,
+                         uint8_t *flags) {
+            const float limit = squaredThreshold(threshold);
+            size_t above = 0;
+            size_t i = 0;
+
+#if ACCEL_BATCH_AVX2
+            const __m256 limit8 = _mm256_set1_ps(limit);
+            __m256i counts8 = _mm256_setzero_si256();
+            for (; i + 8 <= count; i += 8) {
+                const __m256i mask = _mm256_castps_si256(
+                        _mm256_cmp_ps(squared8(x + i, y + i, z + i), limit8, _CMP_GT_OQ));
+                counts8 = _mm256_sub_epi32(counts8, mask);
+                if (WriteFlags) {
+                    const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(mask),
+                                                          _mm256_extracti128_si256(mask, 1));
+                    const __m128i bytes = _mm_and_si128(_mm_packs_epi16(words, words), _mm_set1_epi8(1));
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(flags + i), bytes);
+                }
+            }
+            above += sumLanes(_mm_add_epi32(_mm256_castsi256_si128(counts8), _mm256_extracti128_si256(counts8, 1)));
+#endif
+#if ACCEL_BATCH_SSE2
+            const __m128 limit4 = _mm_set1_ps(limit);
+            __m128i counts4 = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4) {
+                const __m128i mask = _mm_castps_si128(_mm_cmpgt_ps(squared4(x + i, y + i, z + i), limit4));
+                counts4 = _mm_sub_epi32(counts4, mask);
+                if (WriteFlags) {
+                    const __m128i words = _mm_packs_epi32(mask, mask);
+                    const __m128i bytes = _mm_and_si128(_mm_packs_epi16(words, words), _mm_set1_epi8(1));
+                    const int packed = _mm_cvtsi128_si32(bytes);
+                    std::memcpy(flags + i, &packed, 4);
+                }
+            }
+            above += sumLanes(counts4);
+#endif
+            for (; i < count; ++i) {
+                const bool isAbove = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] > limit;
+                if (WriteFlags) {
+                    flags[i] = isAbove ? 1 : 0;
+                }
+                above += isAbove ? 1 : 0;
+            }
+            return above;
+        }
+
+    } // End of anonymous namespace
+
+    namespace AccelerationKernels {
+
+        void squaredMagnitudes(const float *x, const float *y, const float *z, size_t count, float *out) {
+            size_t i = 0;
+#if ACCEL_BATCH_AVX2
+            for (; i + 8 <= count; i += 8) {
+                _mm256_storeu_ps(out + i, squared8(x + i, y + i, z + i));
+            }
+#endif
+#if ACCEL_BATCH_SSE2
+            for (; i + 4 <= count; i += 4) {
+                _mm_storeu_ps(out + i, squared4(x + i, y + i, z + i));
+            }
+#endif
+            for (; i < count; ++i) {
+                out[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            }
+        }
+
+        void magnitudes(const float *x, const float *y, const float *z, size_t count, float *out) {
+            size_t i = 0;
+#if ACCEL_BATCH_AVX2
+            for (; i + 8 <= count; i += 8) {
+                _mm256_storeu_ps(out + i, _mm256_sqrt_ps(squared8(x + i, y + i, z + i)));
+            }
+#endif
+#if ACCEL_BATCH_SSE2
+            for (; i + 4 <= count; i += 4) {
+                _mm_storeu_ps(out + i, _mm_sqrt_ps(squared4(x + i, y + i, z + i)));
+            }
+#endif
+            for (; i < count; ++i) {
+                out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            }
+        }
+
+        size_t markAbove(const float *x, const float *y, const float *z, size_t count, float threshold,
+                         uint8_t *flags) {
+            return testAbove<true>(x, y, z, count, threshold, flags);
+        }
+
+        size_t countAbove(const float *x, const float *y, const float *z, size_t count, float threshold) {
+            return testAbove<false>(x, y, z, count, threshold, nullptr);
+        }
+
+    } // End of namespace AccelerationKernels
+
+    void AccelerometerBatch::reserve(size_t capacity) {
+        x.reserve(capacity);
+        y.reserve(capacity);
+        z.reserve(capacity);
+    }
+
+    void AccelerometerBatch::clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    bool AccelerometerBatch::append(const uint8_t *raw, size_t count, size_t sampleSize, float scale) {
+        if (sampleSize != 6 && sampleSize != 3) {
+            return false;
+        }
+
+        const size_t first = size();
+        x.resize(first + count);
+        y.resize(first + count);
+        z.resize(first + count);
+        float *xOut = x.data() + first;
+        float *yOut = y.data() + first;
+        float *zOut = z.data() + first;
+
+        size_t i = 0;
+        if (sampleSize == 6) {
+#if ACCEL_BATCH_AVX2
+            const __m256 scale8 = _mm256_set1_ps(scale);
+            for (; i + 8 <= count; i += 8) {
+                convert8(raw + i * 6, scale8, xOut + i, yOut + i, zOut + i);
+            }
+#endif
+#if ACCEL_BATCH_SSE2
+            // convert4() reads 2 bytes past its samples, so at least one more sample has to follow
+            const __m128 scale4 = _mm_set1_ps(scale / 65536.0f);
+            for (; i + 4 < count; i += 4) {
+                convert4(raw + i * 6, scale4, xOut + i, yOut + i, zOut + i);
+            }
+#endif
+        }
+        convertScalar(raw + i * sampleSize, count - i, sampleSize, scale, xOut + i, yOut + i, zOut + i);
+        return true;
+    }
+
+    void AccelerometerBatch::push_back(const Accelerometer &sample) {
+        x.push_back(sample.getX());
+        y.push_back(sample.getY());
+        z.push_back(sample.getZ());
+    }
+
+    const char *AccelerometerBatch::simdPath() {
+#if ACCEL_BATCH_AVX2
+        return "AVX2";
+#elif ACCEL_BATCH_SSE2
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+} // End of namespace
@@ -10,23 +10,98 @@
 
 #include "CommunicationModulePC.hpp"
 #include "AccelerometerClass.hpp"
+#include "AccelerationText.hpp"
+#include "BinaryProtocol.hpp"
 #include <iostream>
 #include <cstring>
 #include <sstream>
 #include <cstdint>
 #include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <cctype>
 
 namespace mb {
 
+    namespace {
+
+        /**
+         * @brief Converts a hex digit to its value.
+         * @param c Character to convert.
+         * @return Digit value, or -1 if c is not a hex digit.
+         */
+        int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            return -1;
+        }
+
+        /**
+         * @brief Returns the time left until a deadline in whole milliseconds, rounded up.
+         *
+         * Truncating would turn the last fraction of a millisecond into a 0 ms wait that returns at
+         * once, so a wait for the returned time always reaches the deadline.
+         *
+         * @param deadline Point in time to wait for.
+         * @return Milliseconds left, or 0 once the deadline has passed.
+         */
+        unsigned int millisecondsUntil(std::chrono::steady_clock::time_point deadline) {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+            return (remaining > 0) ? static_cast<unsigned int>(remaining) : 0u;
+        }
+
+        /**
+         * @brief Formats a big-endian int16 in hundredths of a degree as "<degrees>.<hundredths>C".
+         * @param data Two raw temperature bytes.
+         * @param text Destination buffer.
+         * @param size Size of the destination buffer.
+         */
+        void formatTemperature(const uint8_t *data, char *text, size_t size) {
+            int centiDegrees = static_cast<int16_t>((data[0] << 8) | data[1]);
+            std::snprintf(text, size, "%s%d.%02dC", (centiDegrees < 0) ? "-" : "",
+                          std::abs(centiDegrees) / 100, std::abs(centiDegrees) % 100);
+        }
+
+        /**
+         * @brief Parses an unsigned decimal number and advances the view past it and one separator.
+         * @param text View to parse, advanced on success.
+         * @param value Receives the number.
+         * @return False if the view does not start with a digit.
+         */
+        bool takeNumber(std::string_view &text, uint32_t &value) {
+            size_t i = 0;
+            value = 0;
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+                value = value * 10 + static_cast<uint32_t>(text[i++] - '0');
+            }
+            if (i == 0) {
+                return false;
+            }
+            text.remove_prefix(std::min(i + 1, text.size()));
+            return true;
+        }
+
+    } // End of anonymous namespace
+
     CommunicationModulePC::CommunicationModulePC()
-            : CommunicationModulePC("COM6", 9600) {}
+            : CommunicationModulePC(DEFAULT_PORT, 9600) {}
 
     CommunicationModulePC::CommunicationModulePC(const std::string &port, unsigned int baudRate)
-            : serial(port.c_str(), baudRate) {
+            : CommunicationModulePC(port, baudRate, ConnectMode::FixedDelay) {}
+
+    CommunicationModulePC::CommunicationModulePC(const std::string &port, unsigned int baudRate,
+                                                 ConnectMode mode, unsigned int maxConnectMs)
+            : serial(port.c_str(), baudRate, (mode == ConnectMode::FixedDelay) ? ARDUINO_WAIT_TIME : 0),
+              connectMode(mode), maxConnectMs(maxConnectMs) {
         init();
     }
 
     CommunicationModulePC::~CommunicationModulePC() {
+        stopReader(); // The reader thread must not touch the port after it is closed
         serial.closeSerial(); // Ensure UART is closed properly
         std::cout << "[INFO] UART closed on port." << std::endl;
     }
@@ -35,16 +110,236 @@ namespace mb {
         if (!serial.isConnected()) {
             throw std::runtime_error("[ERROR] Failed to connect to UART."); // Handle connection error
         }
+        if (connectMode == ConnectMode::Handshake) {
+            if (!waitForBoard(maxConnectMs)) {
+                throw std::runtime_error("[ERROR] Board did not answer PING."); // Handle handshake timeout
+            }
+            std::cout << "[INFO] Board ready after " << timeToReadyMs << " ms." << std::endl;
+        }
         std::cout << "[INFO] UART initialized on port." << std::endl;
+        // The accelerometer range is asked for before the first sample request, see ensureAccelerationRange()
+    }
+
+    bool CommunicationModulePC::waitForBoard(unsigned int maxWaitMs) {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto deadline = startTime + std::chrono::milliseconds(maxWaitMs);
+        std::string_view line;
+
+        while (std::chrono::steady_clock::now() < deadline) {
+            clearBuffer(); // Drop boot banners and answers to earlier probes
+            println(PING);
+
+            // Wait up to one probe interval for the answer, then send the next probe
+            auto probeDeadline = std::min(deadline,
+                                          std::chrono::steady_clock::now() + std::chrono::milliseconds(PROBE_INTERVAL_MS));
+            while (true) {
+                const unsigned int remainingMs = millisecondsUntil(probeDeadline);
+                if (remainingMs == 0) {
+                    break;
+                }
+
+                if (!nextResponseLine(line, remainingMs)) {
+                    if (!serial.isConnected()) {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (line.find("PONG") != std::string_view::npos) {
+                    timeToReadyMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - startTime).count();
+                    return true;
+                }
+            }
+        }
+
+        return false;
     }
 
     void CommunicationModulePC::clearBuffer() {
-        unsigned char tempBuffer[256];
-        while (serial.readSerialPort(reinterpret_cast<char *>(tempBuffer), sizeof(tempBuffer)) > 0) {
-            // Read data but discard it to clear the buffer
+        if (isReaderRunning()) {
+            while (responses.pop(consumerLine)) {
+                // Drop lines already published by the reader thread
+            }
+            return;
+        }
+        serial.flushInput(); // Drop framed and pending input
+    }
+
+    void CommunicationModulePC::startReader() {
+        if (readerRunning.exchange(true)) {
+            return; // Already running
+        }
+        if (readerThread.joinable()) {
+            readerThread.join(); // A reader that stopped on its own (port disconnected) has exited
+        }
+        readerThread = std::thread(&CommunicationModulePC::readerLoop, this);
+    }
+
+    void CommunicationModulePC::stopReader() {
+        readerRunning.store(false);
+        if (readerThread.joinable()) {
+            readerThread.join();
+        }
+    }
+
+    void CommunicationModulePC::readerLoop() {
+        std::string_view line;
+
+        while (readerRunning.load(std::memory_order_relaxed)) {
+            // Sleeps in the transport; the short slice only bounds how long stopReader() waits
+            bool received = binaryMode.load(std::memory_order_relaxed)
+                            ? serial.readFrame(line, static_cast<char>(BinaryProtocol::FRAME_DELIMITER), READER_WAIT_MS)
+                            : serial.readLine(line, READER_WAIT_MS);
+            if (!received) {
+                if (!serial.isConnected()) {
+                    std::cerr << "[ERROR] UART disconnected, reader thread stopped." << std::endl;
+                    readerRunning.store(false); // Consumers fall back to the port, startReader() can restart
+                    std::lock_guard<std::mutex> lock(responseMutex);
+                    responseReady.notify_all(); // Wake waits that expect the reader to publish
+                    break;
+                }
+                continue;
+            }
+
+            if (!divertStreamSample(line)) {
+                std::string *slot = responses.producerSlot();
+                if (slot == nullptr) {
+                    droppedLines.fetch_add(1, std::memory_order_relaxed); // Consumer fell behind
+                    continue;
+                }
+                slot->assign(line.data(), line.size()); // Reuses the slot's capacity
+                responses.publish();
+            }
+
+            // Only take the mutex when a consumer is actually sleeping
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumerWaiting.load(std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lock(responseMutex);
+                responseReady.notify_one();
+            }
         }
     }
 
+    template <typename Ready>
+    bool CommunicationModulePC::waitForReader(Ready ready, unsigned int timeoutMs) {
+        // Announce the wait before re-checking the queue, so a concurrent publish cannot be missed
+        std::unique_lock<std::mutex> lock(responseMutex);
+        consumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        responseReady.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                               [this, &ready] { return ready() || !readerRunning.load(); });
+        consumerWaiting.store(false, std::memory_order_relaxed);
+        return ready();
+    }
+
+    bool CommunicationModulePC::readResponse(std::string &line, unsigned int timeoutMs) {
+        if (responses.pop(line)) {
+            return true;
+        }
+        if (timeoutMs == 0) {
+            return false;
+        }
+
+        return waitForReader([this] { return !responses.empty(); }, timeoutMs) && responses.pop(line);
+    }
+
+    bool CommunicationModulePC::readIncoming(std::string_view &line, unsigned int timeoutMs) {
+        return binaryMode.load()
+               ? serial.readFrame(line, static_cast<char>(BinaryProtocol::FRAME_DELIMITER), timeoutMs)
+               : serial.readLine(line, timeoutMs);
+    }
+
+    bool CommunicationModulePC::divertStreamSample(std::string_view line) {
+        StreamSample sample;
+
+        if (binaryMode.load(std::memory_order_relaxed)) {
+            // Stream frame: ID, sensor, 4-byte timestamp and data, plus CRC and COBS overhead
+            constexpr size_t minFrameLength = 6 + BinaryProtocol::CRC_SIZE + 1;
+            uint8_t payload[BINARY_PAYLOAD_MAX];
+            if (line.size() < minFrameLength) {
+                return false;
+            }
+            size_t length = BinaryProtocol::decodeFrame(reinterpret_cast<const uint8_t *>(line.data()),
+                                                        line.size(), payload, sizeof(payload));
+            if (length < 6 || payload[0] != BIN_STREAM_SAMPLE) {
+                return false;
+            }
+
+            sample.sensor = payload[1];
+            sample.timestampMs = (static_cast<uint32_t>(payload[2]) << 24) | (static_cast<uint32_t>(payload[3]) << 16)
+                                 | (static_cast<uint32_t>(payload[4]) << 8) | payload[5];
+            sample.length = static_cast<uint8_t>(std::min(length - 6, sample.data.size()));
+            std::copy_n(payload + 6, sample.length, sample.data.begin());
+        } else {
+            if (line.empty() || line.front() != STREAM_MARKER) {
+                return false;
+            }
+
+            // "!<sensor> <timeMs> <value>"
+            std::string_view text = line.substr(1);
+            size_t nameEnd = std::min(text.find(' '), text.size());
+            sample.sensor = binaryCommandId(text.substr(0, nameEnd));
+            text.remove_prefix(std::min(nameEnd + 1, text.size()));
+
+            uint32_t value = 0;
+            bool valid = takeNumber(text, sample.timestampMs);
+            if (sample.sensor == BIN_READ_ACCELERATION) {
+                valid = valid && AccelerationText::parseLine(text, sample.data.data(), sample.length);
+            } else if (sample.sensor == BIN_READ_TEMPERATURE) {
+                bool negative = !text.empty() && text.front() == '-';
+                text.remove_prefix(negative ? 1 : 0);
+                uint32_t hundredths = 0;
+                valid = valid && takeNumber(text, value) && takeNumber(text, hundredths);
+                int centiDegrees = static_cast<int>(value * 100 + hundredths) * (negative ? -1 : 1);
+                sample.data[0] = static_cast<uint8_t>(static_cast<uint16_t>(centiDegrees) >> 8);
+                sample.data[1] = static_cast<uint8_t>(centiDegrees & 0xFF);
+                sample.length = 2;
+            } else if (sample.sensor == BIN_READ_TOUCH) {
+                valid = valid && takeNumber(text, value);
+                sample.data[0] = static_cast<uint8_t>(value);
+                sample.length = 1;
+            } else {
+                valid = false;
+            }
+
+            if (!valid) {
+                std::cerr << "[WARN] Malformed stream line: " << line << std::endl;
+                return true; // Still a stream line, never a command response
+            }
+        }
+
+        if (!streamSamples.push(sample)) {
+            droppedSamples.fetch_add(1, std::memory_order_relaxed); // Consumer fell behind
+        }
+        return true;
+    }
+
+    bool CommunicationModulePC::nextResponseLine(std::string_view &line, unsigned int timeoutMs) {
+        if (!isReaderRunning()) {
+            // Stream samples are queued on the way, only responses are returned
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            while (true) {
+                const unsigned int remainingMs = millisecondsUntil(deadline);
+                if (!readIncoming(line, remainingMs)) {
+                    return false;
+                }
+                if (!divertStreamSample(line)) {
+                    return true;
+                }
+                if (remainingMs == 0) {
+                    return false; // Deadline passed while draining stream samples
+                }
+            }
+        }
+
+        if (!readResponse(consumerLine, timeoutMs)) {
+            return false;
+        }
+        line = consumerLine; // std::string storage is null-terminated as well
+        return true;
+    }
+
     void CommunicationModulePC::print(const char *text) {
         serial.writeSerialPort(text, std::strlen(text)); // Send plain text
     }
@@ -57,105 +352,637 @@ namespace mb {
     }
 
     char *CommunicationModulePC::receiveData() {
-        static char recvBuffer[128];
-        size_t bytesRead = serial.readSerialPort(recvBuffer, sizeof(recvBuffer) - 1);
-        recvBuffer[bytesRead] = '\0'; // Null-terminate the buffer
+        static char emptyLine[] = "";
+        std::string_view line;
+
+        if (!nextResponseLine(line, RESPONSE_TIMEOUT_MS)) {
+            return emptyLine; // Nothing complete arrived in time
+        }
+
+        return const_cast<char *>(line.data()); // Null-terminated in place by the framer, no copy
+    }
+
+    void CommunicationModulePC::printResponse(const char *cmd, const char *line) {
+        std::cout << "[UART RESPONSE] " << line << std::endl;
+        if (std::strncmp(line, ACCEL_RANGE_HEADER, std::strlen(ACCEL_RANGE_HEADER)) == 0) {
+            // Keep parsing in step with a range reported outside setAccelerationRange(), e.g. in a tagged batch
+            applyAccelerationRange(std::strtoul(line + std::strlen(ACCEL_RANGE_HEADER), nullptr, 10));
+        }
+        // Only sample lines start with a digit; ACCEL_NO_SAMPLE, "I2C error: ..." and the batch header are shown as is
+        if ((std::strcmp(cmd, READ_ACCELERATION) == 0 || std::strcmp(cmd, READ_ACCEL_BATCH) == 0)
+            && std::isdigit(static_cast<unsigned char>(line[0]))) {
+            processRawAcceleration(line);
+        } else if (std::strcmp(line, ACCEL_NO_SAMPLE) == 0) {
+            std::cout << "[INFO] The accelerometer has not captured a sample yet, try again shortly." << std::endl;
+        }
+    }
+
+    uint8_t CommunicationModulePC::sendTagged(const char *cmd) {
+        uint8_t tag = nextTag++;
+        PendingReply &reply = pendingReplies[tag];
+        reply = PendingReply{};
+        reply.command = cmd;
+
+        char prefix[5];
+        std::snprintf(prefix, sizeof(prefix), "%c%02X ", TAG_MARKER, tag);
+        println((prefix + reply.command).c_str());
+        return tag;
+    }
+
+    void CommunicationModulePC::dispatchTaggedLine(std::string_view line) {
+        int high = (line.size() >= 4 && line[0] == TAG_MARKER) ? hexValue(line[1]) : -1;
+        int low = (high >= 0) ? hexValue(line[2]) : -1;
+        if (low < 0 || (line[3] != TAG_LINE && line[3] != TAG_END)) {
+            if (!line.empty()) {
+                std::cout << "[UART] " << line << std::endl; // Untagged output, e.g. a boot banner
+            }
+            return;
+        }
+
+        auto it = pendingReplies.find(static_cast<uint8_t>((high << 4) | low));
+        if (it == pendingReplies.end()) {
+            return; // Late reply to a command that already timed out
+        }
+        if (line[3] == TAG_LINE) {
+            it->second.lines.emplace_back(line.substr(4));
+        } else {
+            it->second.complete = true;
+        }
+    }
+
+    bool CommunicationModulePC::awaitTagged(uint8_t tag, std::vector<std::string> &lines, unsigned int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        std::string_view line;
+
+        while (true) {
+            auto it = pendingReplies.find(tag);
+            if (it == pendingReplies.end()) {
+                return false; // Unknown tag
+            }
+            if (it->second.complete) {
+                lines = std::move(it->second.lines);
+                pendingReplies.erase(it);
+                return true;
+            }
 
-        // Remove any trailing newline or carriage return characters
-        for (size_t i = 0; i < bytesRead; ++i) {
-            if (recvBuffer[i] == '\r' || recvBuffer[i] == '\n') {
-                recvBuffer[i] = '\0';
+            const unsigned int remainingMs = millisecondsUntil(deadline);
+            if (remainingMs > 0 && nextResponseLine(line, remainingMs)) {
+                dispatchTaggedLine(line); // May complete a different command first
+                deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            } else if (!serial.isConnected() || std::chrono::steady_clock::now() >= deadline) {
+                lines = std::move(it->second.lines); // Return what arrived before giving up
+                pendingReplies.erase(it);
+                return false;
+            }
+        }
+    }
+
+    void CommunicationModulePC::handleCommands(const std::vector<std::string> &commands) {
+        for (const std::string &command : commands) {
+            if (requestsAccelerationSamples(command.c_str())) {
+                ensureAccelerationRange(); // Before any reply is in flight
                 break;
             }
         }
 
-        return recvBuffer;
+        std::vector<uint8_t> tags;
+        tags.reserve(commands.size());
+        for (const std::string &command : commands) {
+            tags.push_back(sendTagged(command.c_str())); // All commands are in flight at once
+        }
+
+        std::vector<std::string> lines;
+        for (size_t i = 0; i < tags.size(); ++i) {
+            bool complete = awaitTagged(tags[i], lines);
+            for (const std::string &line : lines) {
+                printResponse(commands[i].c_str(), line.c_str());
+            }
+            if (!complete) {
+                std::cerr << "[WARN] Timeout while waiting for response to \"" << commands[i] << "\"." << std::endl;
+            }
+        }
+    }
+
+    bool CommunicationModulePC::setBinaryMode(bool enabled) {
+        if (enabled == binaryMode.load()) {
+            return true;
+        }
+
+        bool acknowledged = false;
+        if (enabled) {
+            clearBuffer();
+            acknowledged = sendAndAwaitAck(SET_BINARY_MODE, BINARY_MODE_ACK);
+        } else {
+            std::vector<uint8_t> data;
+            acknowledged = requestBinary(BIN_SET_TEXT_MODE, data);
+        }
+
+        if (!acknowledged) {
+            std::cerr << "[WARN] MCU did not acknowledge the protocol switch." << std::endl;
+            return false;
+        }
+
+        // The reader thread frames by the protocol's delimiter, so restart it around the switch
+        const bool restartReader = isReaderRunning();
+        stopReader();
+        binaryMode.store(enabled);
+        if (restartReader) {
+            startReader();
+        }
+
+        std::cout << "[INFO] " << (enabled ? "Binary" : "Text") << " protocol active." << std::endl;
+        return true;
+    }
+
+    bool CommunicationModulePC::requestBinary(uint8_t command, std::vector<uint8_t> &data, unsigned int timeoutMs) {
+        return requestBinary(command, {}, data, timeoutMs);
+    }
+
+    bool CommunicationModulePC::requestBinary(uint8_t command, const std::vector<uint8_t> &arguments,
+                                              std::vector<uint8_t> &data, unsigned int timeoutMs) {
+        const uint8_t sequence = nextSequence++;
+        uint8_t request[BINARY_PAYLOAD_MAX];
+        const size_t requestLength = std::min(arguments.size() + 2, sizeof(request));
+        request[0] = command;
+        request[1] = sequence;
+        std::copy_n(arguments.begin(), requestLength - 2, request + 2);
+
+        uint8_t frame[BinaryProtocol::maxFrameSize(sizeof(request))];
+        size_t frameLength = BinaryProtocol::encodeFrame(request, requestLength, frame);
+        serial.writeSerialPort(reinterpret_cast<const char *>(frame), static_cast<unsigned int>(frameLength));
+
+        // Smallest valid response: command, sequence and status plus the CRC, plus one COBS code byte
+        constexpr size_t minFrameLength = 3 + BinaryProtocol::CRC_SIZE + 1;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        uint8_t payload[BINARY_PAYLOAD_MAX];
+        std::string_view received;
+
+        while (true) {
+            const unsigned int remainingMs = millisecondsUntil(deadline);
+            if (remainingMs == 0 || !nextResponseLine(received, remainingMs)) {
+                if (!serial.isConnected() || std::chrono::steady_clock::now() >= deadline) {
+                    std::cerr << "[WARN] Timeout while waiting for response." << std::endl;
+                    return false;
+                }
+                continue;
+            }
+
+            if (received.size() < minFrameLength) {
+                continue; // Line noise, e.g. the "\r" that followed the mode acknowledgement
+            }
+
+            size_t length = BinaryProtocol::decodeFrame(reinterpret_cast<const uint8_t *>(received.data()),
+                                                        received.size(), payload, sizeof(payload));
+            if (length < 3) {
+                std::cerr << "[WARN] Dropped corrupted binary frame." << std::endl;
+                continue;
+            }
+            if (payload[0] == (BIN_ERROR | BIN_RESPONSE_FLAG)) {
+                std::cerr << "[WARN] MCU could not decode the request." << std::endl;
+                return false;
+            }
+            if (payload[0] != (command | BIN_RESPONSE_FLAG) || payload[1] != sequence) {
+                continue; // Stale response to an earlier request
+            }
+            if (payload[2] == BIN_STATUS_NO_SAMPLE) {
+                std::cout << "[INFO] The accelerometer has not captured a sample yet, try again shortly." << std::endl;
+                return false;
+            }
+            if (payload[2] == BIN_STATUS_SENSOR_ERROR) {
+                std::cerr << "[WARN] MCU sensor did not answer (I2C error)." << std::endl;
+                return false;
+            }
+            if (payload[2] != BIN_STATUS_OK) {
+                std::cerr << "[WARN] MCU rejected binary command " << static_cast<int>(command) << "." << std::endl;
+                return false;
+            }
+
+            data.assign(payload + 3, payload + length);
+            return true;
+        }
+    }
+
+    bool CommunicationModulePC::sendAndAwaitAck(const char *cmd, const char *ack, std::string *reply) {
+        println(cmd);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RESPONSE_TIMEOUT_MS);
+        std::string_view line;
+        while (true) {
+            const unsigned int remainingMs = millisecondsUntil(deadline);
+            if (remainingMs == 0 || !nextResponseLine(line, remainingMs)) {
+                std::cerr << "[WARN] No acknowledgement for \"" << cmd << "\"." << std::endl;
+                return false;
+            }
+            if (reply == nullptr && line == ack) {
+                return true;
+            }
+            if (reply != nullptr && line.compare(0, std::strlen(ack), ack) == 0) {
+                reply->assign(line);
+                return true;
+            }
+            std::cout << "[UART RESPONSE] " << line << std::endl; // E.g. an error reply of the MCU
+        }
+    }
+
+    bool CommunicationModulePC::subscribe(const char *sensor, unsigned int periodMs) {
+        const uint8_t sensorId = binaryCommandId(sensor);
+        if (sensorId != BIN_READ_ACCELERATION && sensorId != BIN_READ_TEMPERATURE && sensorId != BIN_READ_TOUCH) {
+            std::cerr << "[WARN] Sensor cannot be streamed: " << sensor << std::endl;
+            return false;
+        }
+        if (periodMs == 0 || periodMs > MAX_STREAM_PERIOD_MS) {
+            std::cerr << "[WARN] Stream period out of range: " << periodMs << " ms" << std::endl;
+            return false;
+        }
+        if (sensorId == BIN_READ_ACCELERATION) {
+            ensureAccelerationRange(); // Streamed samples are scaled with it
+        }
+
+        if (binaryMode.load()) {
+            std::vector<uint8_t> data;
+            return requestBinary(BIN_SUBSCRIBE, {sensorId, static_cast<uint8_t>(periodMs >> 8),
+                                                 static_cast<uint8_t>(periodMs & 0xFF)}, data);
+        }
+
+        std::string command = std::string(SUBSCRIBE) + ' ' + sensor + ' ' + std::to_string(periodMs);
+        return sendAndAwaitAck(command.c_str(), SUBSCRIBE_ACK);
+    }
+
+    bool CommunicationModulePC::unsubscribe(const char *sensor) {
+        if (binaryMode.load()) {
+            std::vector<uint8_t> data;
+            return requestBinary(BIN_UNSUBSCRIBE, {(sensor != nullptr) ? binaryCommandId(sensor) : uint8_t{0}}, data);
+        }
+
+        std::string command = (sensor != nullptr) ? std::string(UNSUBSCRIBE) + ' ' + sensor : std::string(UNSUBSCRIBE);
+        return sendAndAwaitAck(command.c_str(), UNSUBSCRIBE_ACK);
+    }
+
+    bool CommunicationModulePC::applyAccelerationRange(unsigned int rangeG) {
+        if (rangeG != 2 && rangeG != 4 && rangeG != 8) {
+            return false;
+        }
+        accelRangeG = rangeG;
+        accelScale = Accelerometer::scaleForRange(rangeG);
+        accelRangeKnown = true;
+        return true;
+    }
+
+    void CommunicationModulePC::ensureAccelerationRange() {
+        if (accelRangeKnown) {
+            return;
+        }
+        accelRangeKnown = true; // Asked once per session; a failed query keeps the default
+
+        // The MCU may still be in a range set by an earlier session
+        if (!queryAccelerationRange()) {
+            std::cerr << "[WARN] Accelerometer range unknown, assuming +-" << accelRangeG << " g." << std::endl;
+        }
+    }
+
+    bool CommunicationModulePC::requestsAccelerationSamples(const char *cmd) {
+        return std::strcmp(cmd, READ_ACCELERATION) == 0 || std::strcmp(cmd, READ_ACCEL_BATCH) == 0;
+    }
+
+    bool CommunicationModulePC::setAccelerationRange(unsigned int rangeG) {
+        if (rangeG != 2 && rangeG != 4 && rangeG != 8) {
+            std::cerr << "[WARN] Range must be 2, 4 or 8 g: " << rangeG << std::endl;
+            return false;
+        }
+
+        if (binaryMode.load()) {
+            std::vector<uint8_t> data;
+            return requestBinary(BIN_SET_ACCEL_RANGE, {static_cast<uint8_t>(rangeG)}, data)
+                   && data.size() == 1 && applyAccelerationRange(data[0]);
+        }
+
+        // The MCU acknowledges with the active range: "Range: <g>g"
+        std::string command = std::string(SET_ACCEL_RANGE) + ' ' + std::to_string(rangeG);
+        std::string reply;
+        return sendAndAwaitAck(command.c_str(), ACCEL_RANGE_HEADER, &reply)
+               && applyAccelerationRange(std::strtoul(reply.c_str() + std::strlen(ACCEL_RANGE_HEADER), nullptr, 10));
+    }
+
+    bool CommunicationModulePC::queryAccelerationRange() {
+        if (binaryMode.load()) {
+            std::vector<uint8_t> data;
+            return requestBinary(BIN_READ_ACCEL_RANGE, {}, data) && data.size() == 1 && applyAccelerationRange(data[0]);
+        }
+
+        std::string reply;
+        return sendAndAwaitAck(READ_ACCEL_RANGE, ACCEL_RANGE_HEADER, &reply)
+               && applyAccelerationRange(std::strtoul(reply.c_str() + std::strlen(ACCEL_RANGE_HEADER), nullptr, 10));
+    }
+
+    bool CommunicationModulePC::setAccelerationResolution(unsigned int bits) {
+        if (bits != 8 && bits != 14) {
+            std::cerr << "[WARN] Resolution must be 8 or 14 bits: " << bits << std::endl;
+            return false;
+        }
+
+        if (binaryMode.load()) {
+            std::vector<uint8_t> data;
+            return requestBinary(BIN_SET_ACCEL_RES, {static_cast<uint8_t>(bits)}, data);
+        }
+
+        std::string command = std::string(SET_ACCEL_RES) + ' ' + std::to_string(bits);
+        return sendAndAwaitAck(command.c_str(), ACCEL_RES_ACK);
+    }
+
+    bool CommunicationModulePC::readStream(StreamSample &sample, unsigned int timeoutMs) {
+        if (streamSamples.pop(sample)) {
+            return true;
+        }
+
+        if (isReaderRunning()) {
+            return timeoutMs > 0
+                   && waitForReader([this] { return !streamSamples.empty(); }, timeoutMs)
+                   && streamSamples.pop(sample);
+        }
+
+        // No reader thread: drain the port here, printing anything that is not a sample
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        std::string_view line;
+        while (true) {
+            const unsigned int remainingMs = millisecondsUntil(deadline);
+            if (!readIncoming(line, remainingMs)) {
+                return false;
+            }
+            if (!divertStreamSample(line)) {
+                if (!line.empty() && !binaryMode.load()) {
+                    std::cout << "[UART] " << line << std::endl;
+                }
+            } else if (streamSamples.pop(sample)) {
+                return true;
+            }
+            if (remainingMs == 0) {
+                return false; // Deadline passed while other lines kept arriving
+            }
+        }
+    }
+
+    void CommunicationModulePC::printStreamSample(const StreamSample &sample) const {
+        char text[48];
+        switch (sample.sensor) {
+            case BIN_READ_ACCELERATION: {
+                std::cout << "[STREAM " << sample.timestampMs << " ms] " << READ_ACCELERATION << std::endl;
+                Accelerometer accel;
+                if (parseStreamAcceleration(sample, accel)) {
+                    accel.print();
+                }
+                break;
+            }
+            case BIN_READ_TEMPERATURE:
+                formatTemperature(sample.data.data(), text, sizeof(text));
+                std::cout << "[STREAM " << sample.timestampMs << " ms] " << text << std::endl;
+                break;
+            case BIN_READ_TOUCH:
+                std::cout << "[STREAM " << sample.timestampMs << " ms] Slider = "
+                          << static_cast<unsigned int>(sample.data[0]) << std::endl;
+                break;
+            default:
+                break;
+        }
+    }
+
+    bool CommunicationModulePC::parseStreamAcceleration(const StreamSample &sample, Accelerometer &accel) const {
+        return sample.sensor == BIN_READ_ACCELERATION && accel.parseRawData(sample.data.data(), sample.length, accelScale);
+    }
+
+    uint8_t CommunicationModulePC::binaryCommandId(std::string_view cmd) {
+        static const std::pair<const char *, uint8_t> commandTable[] = {
+                {PING,                BIN_PING},
+                {RESET,               BIN_RESET},
+                {GET_SYSTEM_INFO,     BIN_GET_SYSTEM_INFO},
+                {READ_TEMPERATURE,    BIN_READ_TEMPERATURE},
+                {READ_TOUCH,          BIN_READ_TOUCH},
+                {SET_TOUCH,           BIN_SET_TOUCH},
+                {SET_LED_COLOR_RED,   BIN_SET_LED_COLOR_RED},
+                {SET_LED_COLOR_GREEN, BIN_SET_LED_COLOR_GREEN},
+                {SET_LED_COLOR_BLUE,  BIN_SET_LED_COLOR_BLUE},
+                {READ_ACCELERATION,   BIN_READ_ACCELERATION},
+                {READ_ACCEL_BATCH,    BIN_READ_ACCEL_BATCH},
+        };
+
+        const auto entry = std::find_if(std::begin(commandTable), std::end(commandTable),
+                                        [cmd](const auto &item) { return cmd == item.first; });
+        return (entry != std::end(commandTable)) ? entry->second : 0;
+    }
+
+    void CommunicationModulePC::handleBinaryCommand(const char *cmd) {
+        const uint8_t command = binaryCommandId(cmd);
+        if (command == 0) {
+            std::cerr << "[WARN] Command has no binary form: " << cmd << std::endl;
+            return;
+        }
+
+        std::vector<uint8_t> data;
+        if (!requestBinary(command, data, (command == BIN_READ_ACCEL_BATCH) ? BATCH_TIMEOUT_MS : RESPONSE_TIMEOUT_MS)) {
+            return;
+        }
+
+        char text[48];
+        switch (command) {
+            case BIN_PING:
+                std::cout << "[UART RESPONSE] PONG" << std::endl;
+                break;
+            case BIN_RESET:
+                std::cout << "[UART RESPONSE] System resetting..." << std::endl;
+                break;
+            case BIN_GET_SYSTEM_INFO:
+                if (data.size() == 8) {
+                    std::snprintf(text, sizeof(text), "UID: %02X%02X%02X%02X-%02X%02X%02X%02X",
+                                  data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
+                    std::cout << "[UART RESPONSE] Device: FRDM-KL05ZJ" << std::endl;
+                    std::cout << "[UART RESPONSE] " << text << std::endl;
+                }
+                break;
+            case BIN_READ_TEMPERATURE:
+                if (data.size() == 2) {
+                    formatTemperature(data.data(), text, sizeof(text));
+                    std::cout << "[UART RESPONSE] " << text << std::endl;
+                }
+                break;
+            case BIN_READ_TOUCH:
+                if (data.size() == 1) {
+                    std::cout << "[UART RESPONSE] Slider = " << static_cast<unsigned int>(data[0]) << std::endl;
+                }
+                break;
+            case BIN_SET_TOUCH:
+                std::cout << "[UART RESPONSE] TSI calibration..." << std::endl;
+                break;
+            case BIN_SET_LED_COLOR_RED:
+                std::cout << "[UART RESPONSE] LED set to RED!" << std::endl;
+                break;
+            case BIN_SET_LED_COLOR_GREEN:
+                std::cout << "[UART RESPONSE] LED set to GREEN!" << std::endl;
+                break;
+            case BIN_SET_LED_COLOR_BLUE:
+                std::cout << "[UART RESPONSE] LED set to BLUE!" << std::endl;
+                break;
+            case BIN_READ_ACCELERATION: {
+                Accelerometer accel;
+                if (accel.parseRawData(data, accelScale)) { // Raw bytes, no ASCII round trip
+                    accel.print();
+                } else {
+                    std::cerr << "[WARN] Not enough data for accel parse." << std::endl;
+                }
+                break;
+            }
+            case BIN_READ_ACCEL_BATCH: {
+                if (data.empty()) {
+                    break;
+                }
+                // 6 bytes per sample, or 3 in 8-bit mode: the layout follows from the payload size
+                size_t count = data[0] & ~BIN_BATCH_OVERFLOW;
+                const size_t sampleSize = (count > 0 && (data.size() - 1) / count < 6) ? 3 : 6;
+                count = std::min(count, (data.size() - 1) / sampleSize);
+                std::cout << "[UART RESPONSE] " << ACCEL_BATCH_HEADER << " " << count
+                          << ((data[0] & BIN_BATCH_OVERFLOW) ? " overflow" : "") << std::endl;
+                accelBatch.clear();
+                accelBatch.append(data.data() + 1, count, sampleSize, accelScale); // Whole batch in one pass
+                for (size_t i = 0; i < accelBatch.size(); ++i) {
+                    accelBatch[i].print();
+                }
+                break;
+            }
+            default:
+                break;
+        }
     }
 
     void CommunicationModulePC::handleCommand(const char *cmd) {
-        clearBuffer(); // Clear the buffer before sending a command
+        if (std::strcmp(cmd, SET_BINARY_MODE) == 0) {
+            setBinaryMode(true);
+            return;
+        }
+        if (std::strcmp(cmd, SET_TEXT_MODE) == 0) {
+            setBinaryMode(false);
+            return;
+        }
+
+        // "subscribe <sensor> <periodMs>" and "unsubscribe [sensor]" work in every protocol mode
+        if (std::strncmp(cmd, SUBSCRIBE, std::strlen(SUBSCRIBE)) == 0
+            || std::strncmp(cmd, UNSUBSCRIBE, std::strlen(UNSUBSCRIBE)) == 0) {
+            std::istringstream words(cmd);
+            std::string word, sensor;
+            unsigned int periodMs = 0;
+            words >> word >> sensor;
+
+            if (word == UNSUBSCRIBE) {
+                if (unsubscribe(sensor.empty() ? nullptr : sensor.c_str())) {
+                    std::cout << "[INFO] Stream stopped." << std::endl;
+                }
+                return;
+            }
+            if (word == SUBSCRIBE) {
+                if (!(words >> periodMs)) {
+                    std::cerr << "[WARN] Usage: " << SUBSCRIBE << " <sensor> <periodMs>" << std::endl;
+                } else if (subscribe(sensor.c_str(), periodMs)) {
+                    std::cout << "[INFO] Streaming " << sensor << " every " << periodMs << " ms." << std::endl;
+                }
+                return;
+            }
+        }
+        // Accelerometer settings also update how the PC parses samples, in every protocol mode
+        if (std::strncmp(cmd, SET_ACCEL_RES, std::strlen(SET_ACCEL_RES)) == 0
+            || std::strncmp(cmd, SET_ACCEL_RANGE, std::strlen(SET_ACCEL_RANGE)) == 0
+            || std::strcmp(cmd, READ_ACCEL_RANGE) == 0) {
+            std::istringstream words(cmd);
+            std::string word;
+            unsigned int value = 0;
+            words >> word;
+            if (word == SET_ACCEL_RES) {
+                if (!(words >> value)) {
+                    std::cerr << "[WARN] Usage: " << SET_ACCEL_RES << " <8|14>" << std::endl;
+                } else if (setAccelerationResolution(value)) {
+                    std::cout << "[INFO] Accelerometer resolution " << value << " bits." << std::endl;
+                }
+                return;
+            }
+            if (word == SET_ACCEL_RANGE || word == READ_ACCEL_RANGE) {
+                if (word == SET_ACCEL_RANGE && !(words >> value)) {
+                    std::cerr << "[WARN] Usage: " << SET_ACCEL_RANGE << " <2|4|8>" << std::endl;
+                } else if ((word == SET_ACCEL_RANGE) ? setAccelerationRange(value) : queryAccelerationRange()) {
+                    std::cout << "[INFO] Accelerometer range +-" << accelRangeG << " g." << std::endl;
+                }
+                return;
+            }
+        }
+        if (requestsAccelerationSamples(cmd)) {
+            ensureAccelerationRange();
+        }
+        if (binaryMode.load()) {
+            handleBinaryCommand(cmd);
+            return;
+        }
+
+        if (taggedMode) {
+            handleCommands({cmd}); // Replies are matched by tag, no clearing or line counting
+            return;
+        }
+
+        if (isReaderRunning()) {
+            // Lines the board sent since the last command are delivered instead of discarded
+            while (responses.pop(consumerLine)) {
+                std::cout << "[UART] " << consumerLine << std::endl;
+            }
+        } else {
+            clearBuffer(); // Clear the buffer before sending a command
+        }
 
         println(cmd); // Send the command to the microcontroller
 
-        char recvBuffer[128];
-        size_t totalBytesRead = 0;
         int linesReceived = 0;
-        const int maxLines = (std::strcmp(cmd, READ_ACCELERATION) == 0) ? 1 : 2; // Determine the expected number of lines
-        const int timeoutMs = 250; // Timeout for response in milliseconds
-        auto startTime = std::chrono::steady_clock::now();
+        int maxLines = (std::strcmp(cmd, READ_ACCELERATION) == 0) ? 1 : 2; // Determine the expected number of lines
+        const bool batch = std::strcmp(cmd, READ_ACCEL_BATCH) == 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RESPONSE_TIMEOUT_MS);
+        std::string_view line;
 
         while (linesReceived < maxLines) {
-            size_t bytesRead = serial.readSerialPort(recvBuffer + totalBytesRead,
-                                                     sizeof(recvBuffer) - 1 - totalBytesRead);
-
-            if (bytesRead > 0) {
-                totalBytesRead += bytesRead;
-                recvBuffer[totalBytesRead] = '\0'; // Null-terminate the buffer
-
-                // Process each complete line received
-                char *lineStart = recvBuffer;
-                char *lineEnd = nullptr;
-
-                while ((lineEnd = std::strchr(lineStart, '\n')) != nullptr) {
-                    *lineEnd = '\0'; // Terminate the current line
-                    if (std::strcmp(cmd, READ_ACCELERATION) == 0) {
-                        std::cout << "[UART RESPONSE] " << lineStart << std::endl;
-                        processRawAcceleration(lineStart);
-                    } else {
-                        std::cout << "[UART RESPONSE] " << lineStart << std::endl;
-                    }
+            // Sleep in the transport until a complete line arrives or the deadline passes (no busy polling)
+            const unsigned int remainingMs = millisecondsUntil(deadline);
 
-                    linesReceived++;
-                    if (linesReceived >= maxLines) {
-                        return;
-                    }
+            if (remainingMs > 0 && nextResponseLine(line, remainingMs)) {
+                printResponse(cmd, line.data()); // The view is null-terminated in place
 
-                    lineStart = lineEnd + 1; // Move to the next line
+                // A batch announces its length: "Samples: <n>" followed by n sample lines
+                const size_t headerLength = std::strlen(ACCEL_BATCH_HEADER);
+                if (batch && linesReceived == 0 && line.compare(0, headerLength, ACCEL_BATCH_HEADER) == 0) {
+                    maxLines = 1 + static_cast<int>(std::strtoul(line.data() + headerLength, nullptr, 10));
                 }
 
-                // Preserve leftover data for the next read
-                size_t remaining = totalBytesRead - (lineStart - recvBuffer);
-                std::memmove(recvBuffer, lineStart, remaining);
-                totalBytesRead = remaining;
+                linesReceived++;
 
                 // Reset the timeout if data was received
-                startTime = std::chrono::steady_clock::now();
-            }
-
-            // Check if the timeout has been exceeded
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now() - startTime)
-                        .count() > timeoutMs) {
-                if (linesReceived > 0) {
-                    return; // If at least one line was received, return
-                } else {
+                deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RESPONSE_TIMEOUT_MS);
+            } else if (!serial.isConnected()) {
+                std::cerr << "[ERROR] UART disconnected while waiting for response." << std::endl;
+                return;
+            } else {
+                // The deadline has been exceeded
+                if (linesReceived == 0) {
                     std::cerr << "[WARN] Timeout while waiting for response." << std::endl;
-                    return;
                 }
+                return; // If at least one line was received, return
             }
         }
     }
 
     void CommunicationModulePC::processRawAcceleration(const char *rawLine) {
-        uint8_t parsedData[6];
-        int index = 0;
-
-        // Parse the raw acceleration data (6 bytes expected)
-        char *token = std::strtok(const_cast<char *>(rawLine), " ");
-        while (token != nullptr && index < 6) {
-            parsedData[index++] = static_cast<uint8_t>(std::atoi(token));
-            token = std::strtok(nullptr, " ");
+        // Parse the raw acceleration data (6 bytes, or 3 in 8-bit mode) without modifying the line
+        uint8_t parsedData[AccelerationText::MAX_VALUES];
+        uint8_t length = 0;
+        if (!AccelerationText::parseLine(rawLine, parsedData, length)) {
+            std::cerr << "[WARN] Not enough data for accel parse." << std::endl;
+            return;
         }
 
-        if (index == 6) {
-            Accelerometer accel;
-            if (accel.parseRawData(std::vector<uint8_t>(parsedData, parsedData + 6))) {
-                accel.print();
-            } else {
-                std::cerr << "[ERROR] Failed to process acceleration data." << std::endl;
-            }
+        Accelerometer accel;
+        if (accel.parseRawData(parsedData, length, accelScale)) {
+            accel.print();
         } else {
-            std::cerr << "[WARN] Not enough data for accel parse." << std::endl;
+            std::cerr << "[ERROR] Failed to process acceleration data." << std::endl;
         }
     }
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file RxRingBuffer.cpp
+ * @brief Implementation of the contiguous receive buffer and its frame splitter.
+ */
+
+#include "RxRingBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mb {
+
+    RxRingBuffer::RxRingBuffer(size_t capacity, size_t maxCapacity)
+            : storage(std::max<size_t>(capacity, 1)), maxCapacity(std::max(capacity, maxCapacity)) {}
+
+    char *RxRingBuffer::writePointer(size_t &available) {
+        if (head == tail) {
+            // Everything was consumed: restart at the front for free
+            head = tail = scanned = 0;
+        }
+
+        if (tail == storage.size()) {
+            if (head > 0) {
+                // Wrap by moving the unconsumed partial frame to the front (only that frame is copied)
+                std::memmove(storage.data(), storage.data() + head, tail - head);
+                tail -= head;
+                scanned -= head;
+                head = 0;
+            } else if (storage.size() < maxCapacity) {
+                // A single frame fills the whole buffer: grow instead of truncating it
+                storage.resize(std::min(storage.size() * 2, maxCapacity));
+            } else {
+                // Frame larger than the upper bound: drop it up to its delimiter
+                discarding = true;
+                head = tail = scanned = 0;
+            }
+        }
+
+        available = storage.size() - tail;
+        return storage.data() + tail;
+    }
+
+    void RxRingBuffer::commit(size_t count) {
+        tail = std::min(tail + count, storage.size());
+    }
+
+    bool RxRingBuffer::nextFrame(std::string_view &frame, char delimiter) {
+        if (delimiter != scannedFor) {
+            // The framing changed (e.g. text to binary protocol): search the pending bytes again
+            scanned = head;
+            scannedFor = delimiter;
+        }
+
+        while (scanned < tail) {
+            char *begin = storage.data() + scanned;
+            char *end = static_cast<char *>(std::memchr(begin, delimiter, tail - scanned));
+            if (end == nullptr) {
+                scanned = tail; // Remember where to resume the search
+                return false;
+            }
+
+            size_t frameStart = head;
+            size_t frameEnd = static_cast<size_t>(end - storage.data());
+            *end = '\0'; // Terminate in place so the frame is also a C string
+            head = scanned = frameEnd + 1;
+
+            if (discarding) {
+                discarding = false; // Tail of an oversized frame, skip it
+                continue;
+            }
+
+            frame = std::string_view(storage.data() + frameStart, frameEnd - frameStart);
+            return true;
+        }
+        return false;
+    }
+
+    bool RxRingBuffer::nextLine(std::string_view &line) {
+        if (!nextFrame(line, '\n')) {
+            return false;
+        }
+
+        // The MCU terminates lines with "\n\r", so trim '\r' on both ends
+        while (!line.empty() && line.front() == '\r') {
+            line.remove_prefix(1);
+        }
+        while (!line.empty() && line.back() == '\r') {
+            const_cast<char &>(line.back()) = '\0';
+            line.remove_suffix(1);
+        }
+        return true;
+    }
+
+    void RxRingBuffer::clear() {
+        head = tail = scanned = 0;
+        discarding = false;
+    }
+
+} // End of namespace
@@ -7,9 +7,12 @@
 
 #include "SerialPort.hpp"
 
-SerialPort::SerialPort(const char *portName, int baudRate) // Added baudRate - Miroslaw Baca
+#ifdef _WIN32
+
+SerialPort::SerialPort(const char *portName, int baudRate, unsigned int waitTimeMs) // Added baudRate - Miroslaw Baca
 {
     this->connected = false;
+    this->readTimeoutMs = 0;
 
     this->handler = CreateFileA(static_cast<LPCSTR>(portName),
                                 GENERIC_READ | GENERIC_WRITE,
@@ -53,7 +56,10 @@ SerialPort::SerialPort(const char *portName, int baudRate) // Added baudRate - M
             {
                 this->connected = true;
                 PurgeComm(this->handler, PURGE_RXCLEAR | PURGE_TXCLEAR);
-                Sleep(ARDUINO_WAIT_TIME);
+                if (waitTimeMs > 0)
+                {
+                    Sleep(waitTimeMs);
+                }
             }
         }
     }
@@ -70,11 +76,36 @@ SerialPort::~SerialPort()
 
 // Reading bytes from serial port to buffer;
 // returns read bytes count, or if error occurs, returns 0
-int SerialPort::readSerialPort(const char *buffer, unsigned int buf_size)
+int SerialPort::readSerialPort(const char *buffer, unsigned int buf_size, unsigned int timeoutMs)
 {
     DWORD bytesRead{};
     unsigned int toRead = 0;
 
+    if (timeoutMs > 0) // Block in the driver until the first byte or the deadline - Miroslaw Baca
+    {
+        if (this->readTimeoutMs != timeoutMs)
+        {
+            // MAXDWORD/MAXDWORD/constant: return as soon as any byte is available,
+            // otherwise wait at most ReadTotalTimeoutConstant milliseconds
+            COMMTIMEOUTS timeouts = {};
+            timeouts.ReadIntervalTimeout = MAXDWORD;
+            timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+            timeouts.ReadTotalTimeoutConstant = timeoutMs;
+            if (!SetCommTimeouts(this->handler, &timeouts))
+            {
+                return 0;
+            }
+            this->readTimeoutMs = timeoutMs;
+        }
+
+        if (ReadFile(this->handler, (void*) buffer, buf_size, &bytesRead, NULL))
+        {
+            return bytesRead;
+        }
+
+        return 0;
+    }
+
     ClearCommError(this->handler, &this->errors, &this->status);
 
     if (this->status.cbInQue > 0)
@@ -89,8 +120,6 @@ int SerialPort::readSerialPort(const char *buffer, unsigned int buf_size)
         }
     }
 
-    memset((void*) buffer, 0, buf_size);
-
     if (ReadFile(this->handler, (void*) buffer, toRead, &bytesRead, NULL))
     {
         return bytesRead;
@@ -129,3 +158,72 @@ void SerialPort::closeSerial()
 {
     CloseHandle(this->handler);
 }
+
+#endif // _WIN32
+
+// Reading once into the receive buffer, waiting until the deadline for the first byte;
+// returns false if nothing was received - Miroslaw Baca
+bool SerialPort::fillRxBuffer(std::chrono::steady_clock::time_point deadline)
+{
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+
+    size_t available = 0;
+    char *space = this->rxBuffer.writePointer(available);
+    int bytesRead = readSerialPort(space, static_cast<unsigned int>(available),
+                                   (remaining > 0) ? static_cast<unsigned int>(remaining) : 0);
+    if (bytesRead <= 0)
+    {
+        return false;
+    }
+
+    this->rxBuffer.commit(static_cast<size_t>(bytesRead));
+    return true;
+}
+
+// Returning the next complete line (without "\n\r") as a view into the receive buffer;
+// returns false if no complete line arrived before the timeout - Miroslaw Baca
+bool SerialPort::readLine(std::string_view &line, unsigned int timeoutMs)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (!this->rxBuffer.nextLine(line))
+    {
+        if (!fillRxBuffer(deadline))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returning the next frame terminated by delimiter as a view into the receive buffer;
+// returns false if no complete frame arrived before the timeout - Miroslaw Baca
+bool SerialPort::readFrame(std::string_view &frame, char delimiter, unsigned int timeoutMs)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (!this->rxBuffer.nextFrame(frame, delimiter))
+    {
+        if (!fillRxBuffer(deadline))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Discarding buffered and pending input - Miroslaw Baca
+void SerialPort::flushInput()
+{
+    size_t available = 0;
+    char *space = nullptr;
+
+    do
+    {
+        this->rxBuffer.clear();
+        space = this->rxBuffer.writePointer(available);
+    } while (readSerialPort(space, static_cast<unsigned int>(available)) > 0);
+}
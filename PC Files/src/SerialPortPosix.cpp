@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file SerialPortPosix.cpp
+ * @brief termios/epoll implementation of the SerialPort API for Linux hosts.
+ *
+ * Mirrors the behaviour of the Win32 implementation in SerialPort.cpp. Reads never
+ * spin: when no data is queued, readSerialPort() sleeps in epoll_wait() until the
+ * tty becomes readable or the caller's deadline expires. Any tty works, including
+ * the slave side of a pseudo-terminal pair (see openpty(3)).
+ */
+
+#include "SerialPort.hpp"
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+    /**
+     * @brief Maps a numeric baud rate onto the matching termios speed constant.
+     * @param baudRate Baud rate in bits per second.
+     * @param speed Output termios speed constant.
+     * @return True if the baud rate is supported.
+     */
+    bool toTermiosSpeed(int baudRate, speed_t &speed) {
+        switch (baudRate) {
+            case 1200:   speed = B1200;   return true;
+            case 2400:   speed = B2400;   return true;
+            case 4800:   speed = B4800;   return true;
+            case 9600:   speed = B9600;   return true;
+            case 19200:  speed = B19200;  return true;
+            case 38400:  speed = B38400;  return true;
+            case 57600:  speed = B57600;  return true;
+            case 115200: speed = B115200; return true;
+            case 230400: speed = B230400; return true;
+            default:     return false;
+        }
+    }
+
+} // End of anonymous namespace
+
+SerialPort::SerialPort(const char *portName, int baudRate, unsigned int waitTimeMs)
+{
+    this->connected = false;
+    this->epollFd = -1;
+
+    this->handler = open(portName, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (this->handler < 0)
+    {
+        if (errno == ENOENT)
+        {
+            std::cerr << "ERROR: Handle was not attached.Reason : " << portName << " not available\n";
+        }
+        else
+        {
+            std::cerr << "ERROR!!!\n";
+        }
+        return;
+    }
+
+    termios tty = {};
+    speed_t speed = B9600;
+
+    if (tcgetattr(this->handler, &tty) != 0)
+    {
+        std::cerr << "Failed to get current serial parameters\n";
+        return;
+    }
+
+    if (!toTermiosSpeed(baudRate, speed))
+    {
+        std::cout << "ALERT: unsupported baud rate " << baudRate << "\n";
+        return;
+    }
+
+    // 8N1, raw mode, no flow control, reads never block inside the driver
+    cfmakeraw(&tty);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+
+    if (tcsetattr(this->handler, TCSANOW, &tty) != 0)
+    {
+        std::cout << "ALERT: could not set serial port parameters\n";
+        return;
+    }
+
+    this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = this->handler;
+    if (this->epollFd < 0 || epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->handler, &event) != 0)
+    {
+        std::cerr << "ERROR: could not register serial port for readiness events\n";
+        return;
+    }
+
+    this->connected = true;
+    tcflush(this->handler, TCIOFLUSH);
+    if (waitTimeMs > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(waitTimeMs));
+    }
+}
+
+SerialPort::~SerialPort()
+{
+    closeSerial();
+}
+
+// Reading bytes from serial port to buffer;
+// returns read bytes count, or if error occurs or the deadline passes, returns 0
+int SerialPort::readSerialPort(const char *buffer, unsigned int buf_size, unsigned int timeoutMs)
+{
+    if (this->handler < 0 || buf_size == 0)
+    {
+        return 0;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    bool hungUp = false;
+
+    while (true)
+    {
+        ssize_t bytesRead = read(this->handler, (void*) buffer, buf_size);
+        if (bytesRead > 0)
+        {
+            return static_cast<int>(bytesRead);
+        }
+        if (bytesRead < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            if (errno == EIO) // Peer hung up (e.g. USB unplugged or pty master closed)
+            {
+                this->connected = false;
+            }
+            return 0;
+        }
+        if (hungUp)
+        {
+            // epoll reported a hang-up and nothing is left to read (some drivers signal it with EOF, not EIO)
+            this->connected = false;
+            return 0;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+        {
+            return 0;
+        }
+
+        epoll_event event = {};
+        int ready = epoll_wait(this->epollFd, &event, 1, static_cast<int>(remaining));
+        if (ready < 0 && errno != EINTR)
+        {
+            return 0;
+        }
+        if (ready > 0 && (event.events & (EPOLLHUP | EPOLLERR)))
+        {
+            hungUp = true; // Drain what is still buffered first, the next read decides
+        }
+    }
+}
+
+// Sending provided buffer to serial port;
+// returns true if succeed, false if not
+bool SerialPort::writeSerialPort(const char *buffer, unsigned int buf_size)
+{
+    if (this->handler < 0)
+    {
+        return false;
+    }
+
+    unsigned int sent = 0;
+    while (sent < buf_size)
+    {
+        ssize_t bytesSend = write(this->handler, buffer + sent, buf_size - sent);
+        if (bytesSend > 0)
+        {
+            sent += static_cast<unsigned int>(bytesSend);
+            continue;
+        }
+        if (bytesSend < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            return false;
+        }
+
+        // Output queue is full: sleep until the driver drains it instead of retrying
+        pollfd pfd = {this->handler, POLLOUT, 0};
+        if (poll(&pfd, 1, 1000) <= 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Checking if serial port is connected
+bool SerialPort::isConnected()
+{
+    return this->connected;
+}
+
+void SerialPort::closeSerial()
+{
+    if (this->epollFd >= 0)
+    {
+        close(this->epollFd);
+        this->epollFd = -1;
+    }
+    if (this->handler >= 0)
+    {
+        close(this->handler);
+        this->handler = -1;
+    }
+    this->connected = false;
+}
+
+#endif // _WIN32
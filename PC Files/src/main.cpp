@@ -11,8 +11,10 @@
 #include "CommunicationModulePC.hpp"
 #include "AccelerometerClass.hpp"
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
 
-int main() {
+int main(int argc, char* argv[]) {
     mb::Accelerometer TestObj1;
     mb::Accelerometer TestObj2(2.0,1.3,7.0);
     mb::Accelerometer TestObj3(TestObj2);
@@ -45,7 +47,10 @@ int main() {
     }
 
     try {
-        mb::CommunicationModulePC comm("COM6", 9600); // Initialize communication on COM6
+        const char* port = (argc > 1) ? argv[1] : mb::CommunicationModulePC::DEFAULT_PORT;
+        // Initialize communication on COM6 (or the given port), returning as soon as the board answers PING
+        mb::CommunicationModulePC comm(port, 9600, mb::CommunicationModulePC::ConnectMode::Handshake);
+        comm.startReader(); // Keep draining the port between commands
         std::string command;
         while (true) {
             std::cout << "> ";
@@ -54,6 +59,18 @@ int main() {
             if (command == "exit") {
                 break; // Exit the application
             }
+            if (command.rfind("watch", 0) == 0) {
+                // Print subscribed stream samples for the given number of seconds (default 5)
+                int seconds = (command.size() > 6) ? std::atoi(command.c_str() + 6) : 5;
+                auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+                mb::CommunicationModulePC::StreamSample sample;
+                while (std::chrono::steady_clock::now() < end) {
+                    if (comm.readStream(sample, 100)) {
+                        comm.printStreamSample(sample);
+                    }
+                }
+                continue;
+            }
             comm.handleCommand(command.c_str()); // Handle user command
         }
     } catch (const std::exception& ex) {
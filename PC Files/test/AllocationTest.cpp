@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file AllocationTest.cpp
+ * @brief Checks that the accelerometer sample path does not allocate once it has warmed up.
+ *
+ * Global operator new is replaced with a counting version. The test counts allocations while
+ * lines go through AccelerationText::parseLine() and Accelerometer::parseRawData(), and while a
+ * fake board on a pseudo-terminal streams samples that are handed through the streamSamples
+ * queue to readStream() (with and without the reader thread). Every phase must allocate 0 times.
+ */
+
+#include "AccelerationText.hpp"
+#include "BasicAccelerometer.hpp"
+#include "CommunicationModulePC.hpp"
+
+#include <fcntl.h>
+#include <pty.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+
+namespace {
+    std::atomic<bool> counting{false};     /**< True while allocations are counted. */
+    std::atomic<unsigned long> allocations{0};
+}
+
+void *operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+    constexpr unsigned long STEADY_SAMPLES = 2000; /**< Samples counted per phase. */
+
+    int failures = 0;
+    volatile float sink = 0.0f; /**< Keeps the parsed values alive. */
+
+    /**
+     * @brief Reports the allocations of one phase and records a failure if there were any.
+     */
+    void expectNoAllocations(const char *phase, unsigned long samples) {
+        const unsigned long count = allocations.load();
+        std::printf("%-40s samples=%lu allocations=%lu\n", phase, samples, count);
+        if (samples == 0 || count != 0) {
+            std::printf("FAILED: %s\n", phase);
+            ++failures;
+        }
+    }
+
+    void startCounting() {
+        allocations.store(0);
+        counting.store(true);
+    }
+
+    void stopCounting() {
+        counting.store(false);
+    }
+
+    /**
+     * @brief Parses text lines straight into samples, as a capture file reader would.
+     */
+    void testParsing() {
+        const char *lines[] = {"0 16 255 240 64 0\r", "127 252 0 4 128 0", " 12 34 56 \r"};
+        uint8_t data[mb::AccelerationText::MAX_VALUES];
+        uint8_t length = 0;
+        mb::Accelerometer accel;
+        mb::RawAccelerometer raw;
+        unsigned long parsed = 0;
+        float sum = 0.0f;
+
+        startCounting();
+        for (unsigned long i = 0; i < STEADY_SAMPLES; ++i) {
+            if (mb::AccelerationText::parseLine(lines[i % 3], data, length) && accel.parseRawData(data, length)
+                && raw.parseRawData(data, length)) {
+                sum += accel.getZ();
+                ++parsed;
+            }
+        }
+        stopCounting();
+        sink = sum;
+        expectNoAllocations("parseLine + parseRawData", parsed);
+    }
+
+    /**
+     * @brief Minimal board on the master side of a pseudo-terminal.
+     *
+     * Answers the readiness probe and the range query, then streams accelerometer samples
+     * until stopped. It only uses stack buffers, so it does not disturb the counter. Writes do
+     * not block: samples are dropped while the module is not reading, like on a real UART.
+     */
+    class FakeBoard {
+    private:
+        int master;
+        std::atomic<bool> running{true};
+        std::thread thread;
+
+        void run() {
+            char line[64];
+            size_t used = 0;
+            uint32_t timestampMs = 0;
+
+            while (running.load()) {
+                pollfd pending{master, POLLIN, 0};
+                if (poll(&pending, 1, 1) > 0) {
+                    char c;
+                    if (read(master, &c, 1) != 1) {
+                        break;
+                    }
+                    if (c == '\n') {
+                        line[used] = '\0';
+                        const char *reply = std::strstr(line, "range") ? "Range: 2g\n\r" : "PONG\n\r";
+                        (void)!write(master, reply, std::strlen(reply));
+                        used = 0;
+                    } else if (used + 1 < sizeof(line)) {
+                        line[used++] = c;
+                    }
+                    continue;
+                }
+
+                char sample[64];
+                int length = std::snprintf(sample, sizeof(sample), "!readaccel %u 0 %u 255 240 64 0\n\r",
+                                           static_cast<unsigned>(timestampMs), static_cast<unsigned>(timestampMs & 0xFF));
+                (void)!write(master, sample, static_cast<size_t>(length));
+                ++timestampMs;
+            }
+        }
+
+    public:
+        explicit FakeBoard(int master) : master(master) {
+            fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+            thread = std::thread([this] { run(); });
+        }
+
+        ~FakeBoard() {
+            running.store(false);
+            thread.join();
+        }
+    };
+
+    /**
+     * @brief Drains streamed samples from the queue and parses each one.
+     */
+    void testStream(mb::CommunicationModulePC &comm, const char *phase) {
+        mb::CommunicationModulePC::StreamSample sample;
+        mb::Accelerometer accel;
+
+        // Warm-up: queue slots and line buffers reach their steady-state capacity
+        const auto warmEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+        while (std::chrono::steady_clock::now() < warmEnd) {
+            comm.readStream(sample, 50);
+        }
+
+        unsigned long parsed = 0;
+        startCounting();
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (parsed < STEADY_SAMPLES && std::chrono::steady_clock::now() < end) {
+            if (comm.readStream(sample, 50) && comm.parseStreamAcceleration(sample, accel)) {
+                sink = accel.getZ();
+                ++parsed;
+            }
+        }
+        stopCounting();
+        expectNoAllocations(phase, (parsed == STEADY_SAMPLES) ? parsed : 0);
+    }
+}
+
+int main() {
+    testParsing();
+
+    int master = -1;
+    int slave = -1;
+    char name[64];
+    if (openpty(&master, &slave, name, nullptr, nullptr) != 0) {
+        std::perror("openpty");
+        return 1;
+    }
+    termios raw{};
+    tcgetattr(master, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(master, TCSANOW, &raw);
+
+    {
+        FakeBoard board(master);
+        mb::CommunicationModulePC comm(name, 9600, mb::CommunicationModulePC::ConnectMode::Handshake, 2000);
+
+        testStream(comm, "stream hand-off without reader thread");
+        comm.startReader();
+        testStream(comm, "stream hand-off with reader thread");
+        comm.stopReader();
+    }
+
+    close(slave);
+    close(master);
+
+    if (failures != 0) {
+        std::printf("%d phase(s) allocated\n", failures);
+        return 1;
+    }
+    std::printf("No allocations in steady state\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file BatchTest.cpp
+ * @brief Checks AccelerometerBatch::append() against Accelerometer::parseRawData().
+ *
+ * Every element must equal the one parsed one by one, bit for bit, for both sample layouts,
+ * for every count from 0 to 40 (so the vector loops end in every possible tail) and when
+ * appending after existing elements. On POSIX systems the raw samples end right before an
+ * inaccessible page, so a kernel that reads past the last sample crashes the test.
+ */
+
+#include "AccelerometerBatch.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    int failures = 0;
+
+    /**
+     * @brief Byte buffer whose last byte is followed by an inaccessible page where supported.
+     */
+    class GuardedBuffer {
+    private:
+        uint8_t *bytes = nullptr;
+        std::vector<uint8_t> fallback;
+#if !defined(_WIN32)
+        void *mapping = MAP_FAILED;
+        size_t mappingSize = 0;
+#endif
+
+    public:
+        explicit GuardedBuffer(size_t size) {
+#if !defined(_WIN32)
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t dataPages = (size + page - 1) / page + 1;
+            mappingSize = (dataPages + 1) * page;
+            mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping != MAP_FAILED) {
+                uint8_t *guard = static_cast<uint8_t *>(mapping) + dataPages * page;
+                mprotect(guard, page, PROT_NONE);
+                bytes = guard - size;
+                return;
+            }
+#endif
+            fallback.resize(size);
+            bytes = fallback.data();
+        }
+
+        ~GuardedBuffer() {
+#if !defined(_WIN32)
+            if (mapping != MAP_FAILED) {
+                munmap(mapping, mappingSize);
+            }
+#endif
+        }
+
+        GuardedBuffer(const GuardedBuffer &) = delete;
+        GuardedBuffer &operator=(const GuardedBuffer &) = delete;
+
+        uint8_t *data() {
+            return bytes;
+        }
+    };
+
+    /**
+     * @brief Appends count random samples and compares each element with parseRawData().
+     * @param rng Source of the raw bytes.
+     * @param batch Batch to append to; its existing elements are left as they are.
+     * @param count Number of samples.
+     * @param sampleSize Bytes per sample, 6 or 3.
+     * @param scale Scale passed to both paths.
+     */
+    void checkAppend(std::mt19937 &rng, mb::AccelerometerBatch &batch, size_t count, size_t sampleSize, float scale) {
+        GuardedBuffer raw(count * sampleSize);
+        for (size_t i = 0; i < count * sampleSize; ++i) {
+            // Extreme words first (0x7FFF, 0x8000, 0xFFFF, 0x0000), random ones after
+            static const uint8_t EXTREMES[] = {0x7F, 0xFF, 0x80, 0x00, 0xFF, 0xFF, 0x00, 0x00};
+            raw.data()[i] = (i < sizeof(EXTREMES)) ? EXTREMES[i] : static_cast<uint8_t>(rng());
+        }
+
+        const size_t first = batch.size();
+        if (!batch.append(raw.data(), count, sampleSize, scale) || batch.size() != first + count) {
+            std::printf("FAILED: append of %zu %zu-byte samples\n", count, sampleSize);
+            ++failures;
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            mb::Accelerometer expected;
+            expected.parseRawData(raw.data() + i * sampleSize, sampleSize, scale);
+            if (!(batch[first + i] == expected)) {
+                std::printf("FAILED: sample %zu of %zu (%zu-byte layout, scale %g)\n", i, count, sampleSize,
+                            static_cast<double>(scale));
+                ++failures;
+                return;
+            }
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(23);
+    // The +-2/4/8 g scales and one that is not a power of two
+    const float scales[] = {mb::Accelerometer::scaleForRange(2), mb::Accelerometer::scaleForRange(4),
+                            mb::Accelerometer::scaleForRange(8), 0.001f};
+
+    for (float scale : scales) {
+        for (size_t sampleSize : {size_t(6), size_t(3)}) {
+            for (size_t count = 0; count <= 40; ++count) {
+                mb::AccelerometerBatch batch;
+                checkAppend(rng, batch, count, sampleSize, scale);
+                checkAppend(rng, batch, count + 5, sampleSize, scale); // After existing elements
+            }
+        }
+    }
+
+    mb::AccelerometerBatch batch;
+    const uint8_t raw[6] = {};
+    if (batch.append(raw, 1, 4, 1.0f) || batch.size() != 0) {
+        std::printf("FAILED: append accepted a 4-byte sample\n");
+        ++failures;
+    }
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed (%s path)\n", failures, mb::AccelerometerBatch::simdPath());
+        return 1;
+    }
+    std::printf("append() matches parseRawData() (%s path)\n", mb::AccelerometerBatch::simdPath());
+    return 0;
+}
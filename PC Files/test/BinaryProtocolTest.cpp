@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file BinaryProtocolTest.cpp
+ * @brief Checks the COBS + CRC-16 framing of BinaryProtocol.hpp.
+ *
+ * Payloads of every length up to a few COBS blocks, made of zeros, of non-zero bytes and of
+ * random bytes, must survive encodeFrame() and decodeFrame() unchanged, with no 0x00 inside the
+ * frame and within maxFrameSize(). A wrong CRC, every single-bit error in a frame, a 0x00 code
+ * byte, a truncated frame and a payload larger than the destination must all be rejected.
+ */
+
+#include "BinaryProtocol.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    using namespace mb::BinaryProtocol;
+
+    int failures = 0;
+
+    /**
+     * @brief Records a failure if the condition does not hold.
+     */
+    void check(bool passed, const char *what) {
+        if (!passed) {
+            std::printf("FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Encodes the payload, checks the frame's shape and decodes it again.
+     * @return True if the frame is well formed and decodes to the same payload.
+     */
+    bool roundTrips(const std::vector<uint8_t> &payload) {
+        std::vector<uint8_t> frame(maxFrameSize(payload.size()));
+        const size_t frameLength = encodeFrame(payload.data(), payload.size(), frame.data());
+        if (frameLength == 0 || frameLength > frame.size() || frame[frameLength - 1] != FRAME_DELIMITER
+            || std::memchr(frame.data(), 0, frameLength - 1) != nullptr) {
+            return false;
+        }
+
+        std::vector<uint8_t> decoded(payload.size() + CRC_SIZE);
+        const size_t decodedLength = decodeFrame(frame.data(), frameLength - 1, decoded.data(), decoded.size());
+        return decodedLength == payload.size() && std::equal(payload.begin(), payload.end(), decoded.begin());
+    }
+
+    void testCrc() {
+        const char *check9 = "123456789";
+        check(crc16(reinterpret_cast<const uint8_t *>(check9), 9) == 0x29B1, "CRC-16/CCITT-FALSE check value");
+        check(crc16(nullptr, 0) == 0xFFFF, "CRC of no data is the initial value");
+    }
+
+    void testRoundTrip() {
+        std::mt19937 rng(7);
+        for (size_t length = 1; length <= 600; ++length) {
+            // 254 non-zero bytes fill a COBS block, so these lengths cross one or two block boundaries
+            std::vector<uint8_t> zeros(length, 0);
+            std::vector<uint8_t> nonZero(length);
+            std::vector<uint8_t> random(length);
+            for (size_t i = 0; i < length; ++i) {
+                nonZero[i] = static_cast<uint8_t>(1 + i % 255);
+                random[i] = static_cast<uint8_t>(rng() % 4 == 0 ? 0 : rng());
+            }
+            if (!roundTrips(zeros) || !roundTrips(nonZero) || !roundTrips(random)) {
+                std::printf("FAILED: round trip of a %zu-byte payload\n", length);
+                ++failures;
+            }
+        }
+    }
+
+    void testIncrementalEncoder() {
+        const uint8_t data[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+        uint8_t whole[16];
+        uint8_t incremental[16];
+        const size_t length = cobsEncode(data, sizeof(data), whole);
+
+        CobsEncoder encoder(incremental);
+        for (uint8_t byte : data) {
+            encoder.put(byte);
+        }
+        check(encoder.finish() == length && std::memcmp(whole, incremental, length) == 0,
+              "CobsEncoder matches cobsEncode()");
+
+        const uint8_t expected[] = {0x02, 0x11, 0x01, 0x03, 0x22, 0x33, 0x01};
+        check(length == sizeof(expected) && std::memcmp(whole, expected, length) == 0, "COBS output of a known input");
+    }
+
+    void testRejection() {
+        const uint8_t payload[] = {0x83, 0x05, 0x00, 0x12, 0x00, 0xFF};
+        uint8_t frame[maxFrameSize(sizeof(payload))];
+        const size_t frameLength = encodeFrame(payload, sizeof(payload), frame) - 1; // Without the delimiter
+        uint8_t decoded[sizeof(payload) + CRC_SIZE];
+        check(decodeFrame(frame, frameLength, decoded, sizeof(decoded)) == sizeof(payload), "the intact frame decodes");
+
+        // A correctly encoded frame whose CRC does not match the payload
+        uint8_t wrongCrc[sizeof(payload) + CRC_SIZE];
+        std::memcpy(wrongCrc, payload, sizeof(payload));
+        const uint16_t crc = crc16(payload, sizeof(payload)) ^ 0x0100;
+        wrongCrc[sizeof(payload)] = static_cast<uint8_t>(crc >> 8);
+        wrongCrc[sizeof(payload) + 1] = static_cast<uint8_t>(crc & 0xFF);
+        uint8_t badFrame[maxFrameSize(sizeof(wrongCrc))];
+        const size_t badLength = cobsEncode(wrongCrc, sizeof(wrongCrc), badFrame);
+        check(decodeFrame(badFrame, badLength, decoded, sizeof(decoded)) == 0, "a wrong CRC is rejected");
+
+        // Every single-bit error, in the data and in the COBS code bytes
+        bool allRejected = true;
+        for (size_t i = 0; i < frameLength; ++i) {
+            for (int bit = 0; bit < 8; ++bit) {
+                uint8_t corrupted[sizeof(frame)];
+                std::memcpy(corrupted, frame, frameLength);
+                corrupted[i] ^= static_cast<uint8_t>(1u << bit);
+                allRejected = (decodeFrame(corrupted, frameLength, decoded, sizeof(decoded)) == 0) && allRejected;
+            }
+        }
+        check(allRejected, "every single-bit error is rejected");
+
+        uint8_t truncated[sizeof(frame)];
+        std::memcpy(truncated, frame, frameLength);
+        truncated[0] = static_cast<uint8_t>(frameLength + 1); // Code byte points past the end
+        check(decodeFrame(truncated, frameLength, decoded, sizeof(decoded)) == 0, "a truncated block is rejected");
+        check(decodeFrame(frame, frameLength, decoded, sizeof(payload)) == 0, "a payload larger than the destination is rejected");
+        check(decodeFrame(frame, 0, decoded, sizeof(decoded)) == 0, "an empty frame is rejected");
+
+        const uint8_t zeroCode[] = {0x02, 0x11, 0x00, 0x01}; // The second block's code byte is 0x00
+        check(cobsDecode(zeroCode, sizeof(zeroCode), decoded, sizeof(decoded)) == 0, "a 0x00 code byte is rejected");
+    }
+}
+
+int main() {
+    testCrc();
+    testRoundTrip();
+    testIncrementalEncoder();
+    testRejection();
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("COBS + CRC-16 framing passed\n");
+    return 0;
+}
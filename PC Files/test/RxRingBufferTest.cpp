@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file RxRingBufferTest.cpp
+ * @brief Checks the framing of RxRingBuffer when data arrives in arbitrary pieces.
+ *
+ * The bytes are written through writePointer()/commit() in chunks, as SerialPort does, and the
+ * complete lines are taken out after every chunk. Covered: "\n\r" terminators split across
+ * chunks, the wrap that moves a partial frame to the front, growth for a frame longer than the
+ * initial capacity, dropping a frame longer than the upper bound, and a change of delimiter.
+ */
+
+#include "RxRingBuffer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    int failures = 0;
+
+    /**
+     * @brief Records a failure if the condition does not hold.
+     */
+    void check(bool passed, const char *what) {
+        if (!passed) {
+            std::printf("FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Writes text into the buffer chunk by chunk and collects the lines completed so far.
+     * @param buffer Buffer under test.
+     * @param text Received bytes.
+     * @param chunk Largest number of bytes written at once.
+     * @return Lines returned by nextLine(), in order.
+     */
+    std::vector<std::string> receive(mb::RxRingBuffer &buffer, const std::string &text, size_t chunk) {
+        std::vector<std::string> lines;
+        std::string_view line;
+        for (size_t offset = 0; offset < text.size();) {
+            size_t available = 0;
+            char *space = buffer.writePointer(available);
+            const size_t count = std::min({available, chunk, text.size() - offset});
+            std::memcpy(space, text.data() + offset, count);
+            buffer.commit(count);
+            offset += count;
+
+            while (buffer.nextLine(line)) {
+                // The view must also be a C string ending at the line
+                check(std::strlen(line.data()) == line.size(), "a line is null-terminated in place");
+                lines.emplace_back(line);
+            }
+        }
+        return lines;
+    }
+
+    void testSplitTerminators() {
+        const std::string text = "PONG\n\rRange: 2g\n\r\n\r!readaccel 1 2 3\n\r";
+        const std::vector<std::string> expected = {"PONG", "Range: 2g", "", "!readaccel 1 2 3"};
+        for (size_t chunk = 1; chunk <= text.size(); ++chunk) {
+            mb::RxRingBuffer buffer;
+            if (receive(buffer, text, chunk) != expected) {
+                std::printf("FAILED: lines in chunks of %zu\n", chunk);
+                ++failures;
+            }
+            check(buffer.size() == 1, "only the final '\\r' stays pending"); // Trimmed from the next line
+        }
+    }
+
+    void testWrap() {
+        mb::RxRingBuffer buffer(16, 16);
+        check(receive(buffer, "0123456789\nabcde", 16) == std::vector<std::string>{"0123456789"}, "first line");
+        check(buffer.size() == 5, "the partial line stays pending");
+
+        // The tail is at the end: the 5 pending bytes move to the front instead of growing the buffer
+        size_t available = 0;
+        buffer.writePointer(available);
+        check(available == 16 - 5, "the wrap frees everything but the partial line");
+        check(receive(buffer, "fghijk\n", 16) == std::vector<std::string>{"abcdefghijk"}, "the partial line survives the wrap");
+
+        // Many more lines than fit in the storage at once
+        std::string text;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 100; ++i) {
+            expected.push_back("line " + std::to_string(i));
+            text += expected.back() + "\n\r";
+        }
+        check(receive(buffer, text, 5) == expected, "lines keep their order across many wraps");
+    }
+
+    void testGrowth() {
+        mb::RxRingBuffer buffer(8, 64);
+        const std::string longLine(50, 'x');
+        check(receive(buffer, longLine + "\n\rok\n\r", 3) == std::vector<std::string>{longLine, "ok"},
+              "a line longer than the initial capacity is returned whole");
+    }
+
+    void testOversizedFrame() {
+        mb::RxRingBuffer buffer(8, 16);
+        const std::string oversized(40, 'y');
+        check(receive(buffer, "short\n" + oversized + "\nok\n", 4) == std::vector<std::string>{"short", "ok"},
+              "a line longer than the upper bound is dropped up to its delimiter");
+        check(receive(buffer, "next\n", 4) == std::vector<std::string>{"next"}, "framing resumes after the dropped line");
+    }
+
+    void testDelimiterChange() {
+        mb::RxRingBuffer buffer;
+        std::string_view frame;
+        receive(buffer, std::string("text\n\x01\x02\0\x03\0", 10), 10); // Text line, then two binary frames
+        check(buffer.size() == 5, "the binary frames stay pending");
+        check(!buffer.nextLine(frame), "no further line");
+        check(buffer.nextFrame(frame, '\0') && frame == std::string_view("\x01\x02", 2), "bytes scanned for '\\n' are searched for '\\0'");
+        check(buffer.nextFrame(frame, '\0') && frame == "\x03", "second frame");
+        check(!buffer.nextFrame(frame, '\0') && buffer.size() == 0, "nothing left");
+
+        receive(buffer, "pending", 7);
+        buffer.clear();
+        check(buffer.size() == 0 && !buffer.nextLine(frame), "clear() drops a partial frame");
+    }
+}
+
+int main() {
+    testSplitTerminators();
+    testWrap();
+    testGrowth();
+    testOversizedFrame();
+    testDelimiterChange();
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("RxRingBuffer framing passed\n");
+    return 0;
+}
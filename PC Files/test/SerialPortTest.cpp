@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file SerialPortTest.cpp
+ * @brief Checks the termios/epoll SerialPort backend against the slave side of a pseudo-terminal.
+ *
+ * The test holds the master side and plays the board: it checks that a read with nothing to
+ * receive sleeps for its timeout and returns 0, that a line arriving in several pieces is
+ * returned whole by readLine(), and that a board hang-up (master closed) is reported by
+ * isConnected() only once the lines already received have been read.
+ */
+
+#include "SerialPort.hpp"
+
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+namespace {
+    int failures = 0;
+
+    /**
+     * @brief Records a failure if the condition does not hold.
+     */
+    void check(bool passed, const char *what) {
+        if (!passed) {
+            std::printf("FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Pseudo-terminal pair whose slave is opened by name through SerialPort.
+     */
+    class FakeBoard {
+    private:
+        int master = -1;
+        int slave = -1;
+        char name[128] = {};
+
+    public:
+        FakeBoard() {
+            if (openpty(&master, &slave, name, nullptr, nullptr) != 0) {
+                std::perror("openpty");
+                return;
+            }
+            termios raw{};
+            tcgetattr(master, &raw);
+            cfmakeraw(&raw);
+            tcsetattr(master, TCSANOW, &raw);
+        }
+
+        ~FakeBoard() {
+            hangUp();
+            if (slave >= 0) {
+                close(slave);
+            }
+        }
+
+        FakeBoard(const FakeBoard &) = delete;
+        FakeBoard &operator=(const FakeBoard &) = delete;
+
+        bool isOpen() const {
+            return master >= 0;
+        }
+
+        const char *portName() const {
+            return name;
+        }
+
+        /**
+         * @brief Sends bytes to the port, as the board's UART would.
+         */
+        void send(const char *text) {
+            const size_t length = std::strlen(text);
+            if (write(master, text, length) != static_cast<ssize_t>(length)) {
+                std::perror("write");
+            }
+        }
+
+        /**
+         * @brief Closes the master side, like a board that was unplugged.
+         */
+        void hangUp() {
+            if (master >= 0) {
+                close(master);
+                master = -1;
+            }
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    long elapsedMs(Clock::time_point start) {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+    }
+
+    /**
+     * @brief A read with nothing queued waits for its timeout and returns 0, without disconnecting.
+     */
+    void testReadTimeout() {
+        FakeBoard board;
+        SerialPort port(board.portName(), 9600, 0);
+        check(port.isConnected(), "port opens on the pty slave");
+
+        char buffer[16];
+        Clock::time_point start = Clock::now();
+        check(port.readSerialPort(buffer, sizeof(buffer)) == 0, "non-blocking read of an idle port returns 0");
+        check(elapsedMs(start) < 50, "non-blocking read returns immediately");
+
+        start = Clock::now();
+        check(port.readSerialPort(buffer, sizeof(buffer), 200) == 0, "read of an idle port times out with 0");
+        const long waited = elapsedMs(start);
+        check(waited >= 190 && waited < 1000, "read sleeps for its timeout");
+        check(port.isConnected(), "a timeout does not disconnect the port");
+
+        board.send("x");
+        check(port.readSerialPort(buffer, sizeof(buffer), 200) == 1 && buffer[0] == 'x', "read returns queued bytes");
+    }
+
+    /**
+     * @brief A line sent in pieces is returned once it is complete, and the next line starts after "\n\r".
+     */
+    void testPartialLine() {
+        FakeBoard board;
+        SerialPort port(board.portName(), 9600, 0);
+        std::string_view line;
+
+        board.send("!readaccel 12");
+        check(!port.readLine(line, 100), "an unterminated line is not returned");
+
+        board.send("34 1 2 3");
+        check(!port.readLine(line, 100), "a line still without its terminator is not returned");
+
+        board.send(" 4 5 6\n\rPONG");
+        check(port.readLine(line, 200) && line == "!readaccel 1234 1 2 3 4 5 6", "the pieces form one line");
+        check(!port.readLine(line, 100), "the following partial line is kept back");
+
+        board.send("\n\r");
+        check(port.readLine(line, 200) && line == "PONG", "the next line drops the '\\r' of the previous terminator");
+    }
+
+    /**
+     * @brief A hang-up is reported only after the lines already received were read.
+     *
+     * Linux discards tty input that was not read yet when the master closes, so the lines
+     * reach the receive buffer first: one readLine() takes in both.
+     */
+    void testHangUpAfterDrain() {
+        FakeBoard board;
+        SerialPort port(board.portName(), 9600, 0);
+        std::string_view line;
+
+        board.send("first line\n\rlast line\n\r");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Let both lines reach the slave
+        check(port.readLine(line, 200) && line == "first line", "the first line is read");
+        board.hangUp();
+
+        check(port.readLine(line, 200) && line == "last line", "a line received before the hang-up is still returned");
+        check(port.isConnected(), "the port stays connected while received lines are pending");
+
+        char buffer[16];
+        const Clock::time_point start = Clock::now();
+        check(port.readSerialPort(buffer, sizeof(buffer), 1000) == 0, "reading past the hang-up returns 0");
+        check(elapsedMs(start) < 500, "the hang-up ends the wait before the timeout");
+        check(!port.isConnected(), "the drained port reports the hang-up");
+        check(!port.readLine(line, 100), "no line follows the hang-up");
+    }
+}
+
+int main() {
+    if (!FakeBoard().isOpen()) {
+        return 1;
+    }
+
+    testReadTimeout();
+    testPartialLine();
+    testHangUpAfterDrain();
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("SerialPort reads, partial lines and hang-up behave on a pseudo-terminal\n");
+    return 0;
+}
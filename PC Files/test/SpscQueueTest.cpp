@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file SpscQueueTest.cpp
+ * @brief Checks the full and empty conditions of SpscQueue and its hand-off between two threads.
+ *
+ * On one thread: push() fails exactly when Capacity values are queued, pop() fails exactly when
+ * none are, the order survives the indices wrapping around the slots many times, and pop()
+ * swaps the slot with the caller's object so string buffers circulate. On two threads: every
+ * value pushed by the producer arrives at the consumer once and in order.
+ */
+
+#include "SpscQueue.hpp"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace {
+    int failures = 0;
+
+    /**
+     * @brief Records a failure if the condition does not hold.
+     */
+    void check(bool passed, const char *what) {
+        if (!passed) {
+            std::printf("FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    void testFullAndEmpty() {
+        mb::SpscQueue<int, 4> queue;
+        int value = -1;
+        check(queue.empty() && !queue.pop(value) && value == -1, "a new queue is empty");
+
+        for (int i = 0; i < 4; ++i) {
+            check(queue.push(i), "push below capacity");
+        }
+        check(!queue.push(4) && queue.producerSlot() == nullptr, "push to a full queue fails");
+
+        check(queue.pop(value) && value == 0, "pop returns the oldest value");
+        check(queue.push(4), "pop frees one slot");
+        check(!queue.push(5), "and only one");
+
+        for (int expected = 1; expected <= 4; ++expected) {
+            check(queue.pop(value) && value == expected, "values come out in order");
+        }
+        check(queue.empty() && !queue.pop(value) && queue.consumerSlot() == nullptr, "pop from an empty queue fails");
+    }
+
+    void testWrapAround() {
+        mb::SpscQueue<int, 4> queue;
+        int next = 0;
+        int expected = 0;
+        bool inOrder = true;
+        for (int round = 0; round < 1000; ++round) {
+            // A varying fill level moves the indices through every slot
+            for (int i = 0; i <= round % 4; ++i) {
+                inOrder = queue.push(next++) && inOrder;
+            }
+            int value = 0;
+            while (queue.pop(value)) {
+                inOrder = (value == expected++) && inOrder;
+            }
+        }
+        check(inOrder && next == expected, "order is kept while the indices wrap");
+    }
+
+    void testSwapKeepsBuffers() {
+        mb::SpscQueue<std::string, 2> queue;
+        std::string line(100, 'a');
+        const char *storage = line.data();
+        check(queue.push(std::move(line)), "push a long string");
+
+        std::string out;
+        check(queue.pop(out) && out.size() == 100, "pop it");
+        check(out.data() == storage, "the string was handed over, not copied");
+
+        // The caller's previous buffer goes into the slot, where the producer reuses it
+        std::string received(200, 'b');
+        const char *previous = received.data();
+        check(queue.push(std::string("x")) && queue.pop(received) && received == "x", "pop into a used string");
+        check(queue.push(std::string("y")), "fill the other slot");
+        std::string *slot = queue.producerSlot(); // The slot "x" was popped from
+        check(slot != nullptr && slot->data() == previous && slot->capacity() >= 200, "the caller's buffer is back in the ring");
+    }
+
+    void testTwoThreads() {
+        constexpr unsigned int COUNT = 200000;
+        mb::SpscQueue<unsigned int, 8> queue; // Small, so both sides often find it full or empty
+        unsigned int received = 0;
+        bool inOrder = true;
+
+        std::thread consumer([&] {
+            unsigned int value = 0;
+            while (received < COUNT) {
+                if (queue.pop(value)) {
+                    inOrder = (value == received) && inOrder;
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        for (unsigned int i = 0; i < COUNT; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+
+        check(received == COUNT && inOrder && queue.empty(), "every value crosses the threads once and in order");
+    }
+}
+
+int main() {
+    testFullAndEmpty();
+    testWrapAround();
+    testSwapKeepsBuffers();
+    testTwoThreads();
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("SpscQueue passed\n");
+    return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 Miroslaw Baca
+ * AGH - Object-Oriented Programming Language
+ */
+
+/**
+ * @file TaggedProtocolTest.cpp
+ * @brief Checks the tagged request/response protocol of CommunicationModulePC against a fake board.
+ *
+ * The board sits on the master side of a pseudo-terminal. It answers the PING handshake and
+ * records the tagged requests; the test then writes the replies itself, in the order a case
+ * needs. Covered: the "#XX cmd" request format, replies of several commands interleaved with
+ * each other and with untagged and stream lines, the "#XX." end marker (also with no payload),
+ * lines with an unknown or malformed tag, and a reply whose end marker never arrives.
+ */
+
+#include "CommunicationModulePC.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    int failures = 0;
+
+    /**
+     * @brief Records a failure if the condition does not hold.
+     */
+    void check(bool passed, const char *what) {
+        if (!passed) {
+            std::printf("FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Board on the master side of a pseudo-terminal that answers PING and records the other requests.
+     */
+    class FakeBoard {
+    private:
+        int master;
+        std::atomic<bool> running{true};
+        std::mutex requestsMutex;
+        std::vector<std::string> requests;
+        std::thread thread;
+
+        void run() {
+            std::string line;
+            while (running.load()) {
+                pollfd pending{master, POLLIN, 0};
+                if (poll(&pending, 1, 10) <= 0) {
+                    continue;
+                }
+                char c;
+                if (read(master, &c, 1) != 1) {
+                    continue;
+                }
+                if (c == '\r') {
+                    continue;
+                }
+                if (c != '\n') {
+                    line += c;
+                    continue;
+                }
+
+                if (line == "ping") {
+                    send("PONG\n\r");
+                } else {
+                    std::lock_guard<std::mutex> lock(requestsMutex);
+                    requests.push_back(line);
+                }
+                line.clear();
+            }
+        }
+
+    public:
+        explicit FakeBoard(int master) : master(master) {
+            thread = std::thread([this] { run(); });
+        }
+
+        ~FakeBoard() {
+            running.store(false);
+            thread.join();
+        }
+
+        /**
+         * @brief Writes bytes to the module, as the board's UART would.
+         */
+        void send(const std::string &text) {
+            if (write(master, text.data(), text.size()) != static_cast<ssize_t>(text.size())) {
+                std::perror("write");
+            }
+        }
+
+        /**
+         * @brief Waits until count requests other than PING have arrived and returns them.
+         */
+        std::vector<std::string> awaitRequests(size_t count) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (std::chrono::steady_clock::now() < deadline) {
+                {
+                    std::lock_guard<std::mutex> lock(requestsMutex);
+                    if (requests.size() >= count) {
+                        std::vector<std::string> received;
+                        received.swap(requests);
+                        return received;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            return {};
+        }
+    };
+
+    /**
+     * @brief Builds a reply line "#XX<rest>\n\r" for the given tag.
+     * @param tag Sequence tag.
+     * @param rest Text after the tag, starting with ':' or '.'.
+     */
+    std::string tagged(uint8_t tag, const char *rest) {
+        char prefix[4];
+        std::snprintf(prefix, sizeof(prefix), "#%02X", tag);
+        return prefix + std::string(rest) + "\n\r";
+    }
+
+    void testRequestFormat(mb::CommunicationModulePC &comm, FakeBoard &board) {
+        const uint8_t first = comm.sendTagged("readtemp");
+        const uint8_t second = comm.sendTagged("readtouch");
+        check(static_cast<uint8_t>(second - first) == 1, "tags are consecutive");
+
+        char expected[2][32];
+        std::snprintf(expected[0], sizeof(expected[0]), "#%02X readtemp", first);
+        std::snprintf(expected[1], sizeof(expected[1]), "#%02X readtouch", second);
+        const std::vector<std::string> requests = board.awaitRequests(2);
+        check(requests.size() == 2 && requests[0] == expected[0] && requests[1] == expected[1],
+              "requests are sent as \"#XX cmd\"");
+
+        board.send(tagged(first, ".") + tagged(second, "."));
+        std::vector<std::string> lines{"stale"};
+        check(comm.awaitTagged(first, lines, 1000) && lines.empty(), "an end marker alone is an empty reply");
+        check(comm.awaitTagged(second, lines, 1000) && lines.empty(), "second empty reply");
+    }
+
+    void testInterleavedReplies(mb::CommunicationModulePC &comm, FakeBoard &board) {
+        const uint8_t a = comm.sendTagged("a");
+        const uint8_t b = comm.sendTagged("b");
+        board.awaitRequests(2);
+
+        // b completes first; untagged and stream lines in between belong to neither
+        board.send(tagged(b, ":beta 1") + "Boot banner\n\r" + tagged(a, ":alpha 1")
+                   + "!readaccel 5 0 0 0 0 0 0\n\r" + tagged(b, ".") + tagged(a, ":alpha 2") + tagged(a, "."));
+
+        std::vector<std::string> lines;
+        check(comm.awaitTagged(a, lines, 1000) && lines == std::vector<std::string>{"alpha 1", "alpha 2"},
+              "a reply is collected while another command's reply arrives");
+        check(comm.awaitTagged(b, lines, 1000) && lines == std::vector<std::string>{"beta 1"},
+              "a reply that completed while waiting for another one is kept");
+        check(!comm.awaitTagged(b, lines, 100), "a collected reply cannot be awaited again");
+    }
+
+    void testMismatchedTags(mb::CommunicationModulePC &comm, FakeBoard &board) {
+        const uint8_t c = comm.sendTagged("c");
+        board.awaitRequests(1);
+
+        const uint8_t other = static_cast<uint8_t>(c + 0x40); // Not in flight
+        board.send(tagged(other, ":not mine") + tagged(other, ".") + "#0G:bad hex\n\r" + "#12 no separator\n\r"
+                   + tagged(c, ":mine") + tagged(c, "."));
+
+        std::vector<std::string> lines;
+        check(comm.awaitTagged(c, lines, 1000) && lines == std::vector<std::string>{"mine"},
+              "lines with another or a malformed tag are not part of the reply");
+    }
+
+    void testMissingEndMarker(mb::CommunicationModulePC &comm, FakeBoard &board) {
+        const uint8_t d = comm.sendTagged("d");
+        board.awaitRequests(1);
+        board.send(tagged(d, ":partial"));
+
+        std::vector<std::string> lines;
+        const auto start = std::chrono::steady_clock::now();
+        check(!comm.awaitTagged(d, lines, 200), "a reply without its end marker times out");
+        check(std::chrono::steady_clock::now() - start < std::chrono::seconds(2), "the timeout is kept");
+        check(lines == std::vector<std::string>{"partial"}, "the lines received before the timeout are returned");
+
+        // The late end marker must not confuse the next command
+        const uint8_t e = comm.sendTagged("e");
+        board.awaitRequests(1);
+        board.send(tagged(d, ".") + tagged(e, ":fresh") + tagged(e, "."));
+        check(comm.awaitTagged(e, lines, 1000) && lines == std::vector<std::string>{"fresh"},
+              "a late end marker of a timed-out command is ignored");
+    }
+}
+
+int main() {
+    int master = -1;
+    int slave = -1;
+    char name[64];
+    if (openpty(&master, &slave, name, nullptr, nullptr) != 0) {
+        std::perror("openpty");
+        return 1;
+    }
+    termios raw{};
+    tcgetattr(master, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(master, TCSANOW, &raw);
+
+    {
+        FakeBoard board(master);
+        mb::CommunicationModulePC comm(name, 9600, mb::CommunicationModulePC::ConnectMode::Handshake, 2000);
+
+        testRequestFormat(comm, board);
+        testInterleavedReplies(comm, board);
+        testMismatchedTags(comm, board);
+        testMissingEndMarker(comm, board);
+    }
+
+    close(slave);
+    close(master);
+
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("Tagged protocol passed\n");
+    return 0;
+}